@@ -6,16 +6,18 @@
 #include <string.h>
 #include <stdarg.h>
 #include <ctype.h>
-#include <setjmp.h>
 #include <math.h>
 #include "../../../../shared/runtime/abi/abi.h"
+#include "../../../../shared/runtime/abi/std/gc/gc.h"
 #define UTF8PROC_STATIC
 #include "../../../../stdlib/modules/shared/unicode/proc/vendor/utf8proc.h"
 #if defined(_WIN32)
 #include <direct.h>
+#include <setjmp.h>
 #else
 #include <sys/stat.h>
 #include <unistd.h>
+#include <unwind.h>
 #endif
 
 #if defined(_MSC_VER)
@@ -24,7 +26,11 @@
 #define NORETURN __attribute__((noreturn))
 #endif
 
-#define DS_BOX_MAGIC 0x4453564cU
+/* The low byte is NUL, so no non-empty C string starts with the box magic.
+ * Runtime and literal strings keep at least four bytes of data, so an empty
+ * one cannot either. */
+#define DS_BOX_MAGIC 0x44535600U
+#define DS_STRING_MAGIC 0x4453535452494e47ULL
 
 typedef enum {
     DS_VALUE_INT32,
@@ -45,6 +51,19 @@ typedef enum {
     DS_VALUE_BAG
 } DSValueKind;
 
+/* Header in front of the bytes of every string the runtime allocates and of
+ * every string literal the backend emits. Strings are still passed around as
+ * NUL-terminated `char *`; the header only caches what would otherwise take
+ * a scan. `hash` is 0 until first computed (see ds_hash_string). Every
+ * unboxed string value carries one: text from anywhere else (argv, libc, io
+ * reads, C literals) is copied in with ds_strdup before it becomes a value,
+ * so the header is never guessed from the bytes in front of a pointer. */
+typedef struct {
+    uint64_t magic;
+    int64_t length;
+    uint64_t hash;
+} DSStringHeader;
+
 typedef struct {
     uint32_t magic;
     DSValueKind kind;
@@ -57,20 +76,29 @@ typedef struct {
     } as;
 } DSValue;
 
+/* `capacity` is the allocated size of `items`; arrays built at their final
+ * length leave it 0 and are copied into a growable buffer on first push. */
 typedef struct {
     int64_t length;
     void **items;
+    int64_t capacity;
 } DSArray;
 
-typedef struct DSMapEntry {
+typedef struct {
     void *key;
     void *value;
-    struct DSMapEntry *next;
+    uint64_t hash;
 } DSMapEntry;
 
+/* Entries are kept densely in insertion order, which is the order every map
+ * method iterates in. `index` is an open-addressing table (linear probing,
+ * power-of-two size) of positions into `entries`; empty buckets hold -1. */
 typedef struct {
-    DSMapEntry *head;
+    DSMapEntry *entries;
     int64_t count;
+    int64_t capacity;
+    int64_t *index;
+    int64_t index_size;
 } DSMap;
 
 typedef void* (*BlockFunc)(void*, int64_t, void**);
@@ -82,37 +110,29 @@ typedef struct {
 
 static void *ds_alloc(size_t size);
 
-static void ds_map_append_entry(DSMap *map, void *key, void *value) {
-    DSMapEntry *entry = (DSMapEntry *)ds_alloc(sizeof(DSMapEntry));
-    entry->key = key;
-    entry->value = value;
-    entry->next = NULL;
-
-    if (!map->head) {
-        map->head = entry;
-    } else {
-        DSMapEntry *tail = map->head;
-        while (tail->next) {
-            tail = tail->next;
-        }
-        tail->next = entry;
-    }
-
-    map->count++;
-}
+_Bool dragonstone_runtime_case_compare(void *lhs, void *rhs);
+static DSMap *ds_map_new(int64_t capacity);
+static DSMapEntry *ds_map_find(DSMap *map, void *key);
+static void ds_map_set(DSMap *map, void *key, void *value);
+static void ds_map_append_entry(DSMap *map, void *key, void *value);
 
 typedef struct DSMethod {
     char *name;
+    int64_t selector;
     void *func_ptr;
     bool expects_block;
     struct DSMethod *next;
 } DSMethod;
 
+/* `next` chains every singleton method in definition order (newest first);
+ * `next_same` chains only those sharing a selector, for dispatch. */
 typedef struct DSSingletonMethod {
     void *receiver;
     char *name;
+    int64_t selector;
     void *func_ptr;
     struct DSSingletonMethod *next;
+    struct DSSingletonMethod *next_same;
 } DSSingletonMethod;
 
 typedef struct DSConstant {
@@ -121,6 +141,13 @@ typedef struct DSConstant {
     struct DSConstant *next;
 } DSConstant;
 
+/* One resolved lookup in a class method table; `method` is NULL for a
+ * selector known to be missing from the class and its ancestors. */
+typedef struct {
+    int64_t selector;
+    DSMethod *method;
+} DSMethodSlot;
+
 typedef struct DSClass {
     char *name;
     DSMethod *methods;
@@ -129,11 +156,35 @@ typedef struct DSClass {
     struct DSClass *next;
     bool is_module;
     void *cached_box;
+    DSMethodSlot *mtable;
+    int64_t mtable_size;
+    int64_t mtable_count;
+    uint64_t mtable_epoch;
+    /* Instance-variable layout registered by compiled code: slot i of an
+     * instance holds `ivar_names[i]`. `ivar_verified` caches the last
+     * layout accepted as a prefix of this one. */
+    char **ivar_names;
+    int64_t ivar_count;
+    char **ivar_verified;
 } DSClass;
 
+/* Per-call-site inline cache, one zero-initialised global per site in the
+ * generated IR. `klass` is the DSClass of an instance receiver or the class
+ * box itself for class-level calls. */
+typedef struct {
+    void *klass;
+    void *func_ptr;
+    int64_t expects_block;
+    uint64_t epoch;
+} DSCallCache;
+
+/* Instance variables in the class layout live inline in `slots`; any other
+ * name set at runtime goes to the `ivars` overflow map. */
 typedef struct {
     DSClass *klass;
     DSMap *ivars;
+    int64_t slot_count;
+    void *slots[];
 } DSInstance;
 
 typedef struct {
@@ -170,12 +221,32 @@ typedef struct {
 
 static DSClass *global_classes = NULL;
 
+#if defined(_WIN32)
+/* MSVC targets have no Itanium unwinder, so begin/rescue there still pushes a
+ * setjmp frame. `area` and `gc_disable_depth` record the GC state at the
+ * handler so a raise out of @[Garbage(area)] / @[Garbage(disable)] functions
+ * can restore it. */
 typedef struct DSExceptionFrame {
     jmp_buf env;
     struct DSExceptionFrame *prev;
+    DragonstoneGcArea *area;
+    int gc_disable_depth;
 } DSExceptionFrame;
 
 static DSExceptionFrame *top_exception_frame = NULL;
+#else
+/* Everywhere else raise is table driven: compiled code reaches rescue blocks
+ * through invoke/landingpad and dragonstone_runtime_personality, so entering
+ * a begin block costs nothing. */
+typedef struct {
+    struct _Unwind_Exception header;
+    void *payload;
+} DSException;
+
+/* "DRGNDS\0\0" */
+static const uint64_t DS_EXCEPTION_CLASS = 0x4452474E44530000ULL;
+#endif
+
 static void *current_exception_object = NULL;
 static DSSingletonMethod *singleton_methods = NULL;
 static DSValue *root_self_box = NULL;
@@ -189,9 +260,12 @@ static void *ds_builtin_stdin_class = NULL;
 static void *ds_builtin_argf_class = NULL;
 static bool ds_io_builtins_initialized = false;
 
+#if defined(_WIN32)
 void dragonstone_runtime_push_exception_frame(void *frame_ptr) {
     DSExceptionFrame *frame = (DSExceptionFrame *)frame_ptr;
     frame->prev = top_exception_frame;
+    frame->area = dragonstone_gc_current_area();
+    frame->gc_disable_depth = dragonstone_gc_disable_depth();
     top_exception_frame = frame;
 }
 
@@ -200,31 +274,144 @@ void dragonstone_runtime_pop_exception_frame(void) {
         top_exception_frame = top_exception_frame->prev;
     }
 }
+#endif
 
 void *dragonstone_runtime_get_exception(void) {
     return current_exception_object;
 }
 
-static const char DS_STR_NIL_VAL[] = "nil";
-static const char DS_STR_TRUE_VAL[] = "true";
-static const char DS_STR_FALSE_VAL[] = "false";
+/* Constant string values, laid out like a runtime string so their header
+ * is where every string value keeps it. */
+typedef struct {
+    DSStringHeader header;
+    char bytes[8];
+} DSStaticString;
+
+#define DS_STATIC_STRING(text) {{DS_STRING_MAGIC, (int64_t)sizeof(text) - 1, 0}, text}
+
+static DSStaticString DS_STR_NIL_VAL = DS_STATIC_STRING("nil");
+static DSStaticString DS_STR_TRUE_VAL = DS_STATIC_STRING("true");
+static DSStaticString DS_STR_FALSE_VAL = DS_STATIC_STRING("false");
 
 static DSConstant *global_constants = NULL;
+
+/* Runtime state that outlives any one call (selectors, method tables, shared
+ * immediates, class records) must not land in a @[Garbage(area)] area, which
+ * frees everything when the annotated function returns. While this is
+ * non-zero every allocation goes straight to the collected heap. */
+static int ds_global_alloc_depth = 0;
+
+NORETURN static void ds_out_of_memory(void) {
+    fprintf(stderr, "[fatal] Out of memory\n");
+    abort();
+}
+
+/* Memory that may hold pointers to other runtime values. Always zeroed:
+ * Boehm clears its blocks, area blocks come from malloc and do not. */
 static void *ds_alloc(size_t size) {
-    void *buffer = calloc(1, size);
-    if (!buffer) {
-        fprintf(stderr, "[fatal] Out of memory\n");
-        abort();
-    }
+    if (size == 0) size = 1;
+    bool global = ds_global_alloc_depth > 0;
+    void *buffer = global ? dragonstone_gc_alloc_global(size) : dragonstone_gc_alloc(size);
+    if (!buffer) ds_out_of_memory();
+    if (!global && dragonstone_gc_current_area()) memset(buffer, 0, size);
+    return buffer;
+}
+
+/* Pointer-free memory (string bytes, scratch buffers) that the collector
+ * never scans. Not zeroed. */
+static void *ds_alloc_atomic(size_t size) {
+    if (size == 0) size = 1;
+    if (ds_global_alloc_depth > 0) return ds_alloc(size);
+    void *buffer = dragonstone_gc_alloc_atomic(size);
+    if (!buffer) ds_out_of_memory();
     return buffer;
 }
 
+/* Grows a buffer from ds_alloc/ds_alloc_atomic. The new tail is not zeroed. */
+static void *ds_realloc(void *buffer, size_t old_size, size_t size, bool atomic) {
+    if (size <= old_size && buffer) return buffer;
+    void *grown = atomic ? ds_alloc_atomic(size) : ds_alloc(size);
+    if (buffer && old_size > 0) memcpy(grown, buffer, old_size);
+    return grown;
+}
+
+/* Only valid on string values, which the runtime or the backend built. */
+static inline DSStringHeader *ds_string_header(const void *str) {
+    return (DSStringHeader *)str - 1;
+}
+
+/* A string of `length` bytes with its terminator set; the caller fills in
+ * the bytes. */
+static char *ds_string_new(size_t length) {
+    size_t data = length + 1 < 4 ? 4 : length + 1;
+    DSStringHeader *header = (DSStringHeader *)ds_alloc_atomic(sizeof(DSStringHeader) + data);
+    header->magic = DS_STRING_MAGIC;
+    header->length = (int64_t)length;
+    header->hash = 0;
+    char *bytes = (char *)(header + 1);
+    memset(bytes + length, 0, data - length);
+    return bytes;
+}
+
+static char *ds_string_from(const char *bytes, size_t length) {
+    char *copy = ds_string_new(length);
+    if (length > 0) memcpy(copy, bytes, length);
+    return copy;
+}
+
+/* Shortens a string from ds_string_new when fewer bytes than reserved were
+ * written, keeping everything past the new end zeroed. */
+static char *ds_string_truncate(char *str, size_t length) {
+    DSStringHeader *header = (DSStringHeader *)str - 1;
+    memset(str + length, 0, (size_t)header->length - length);
+    header->length = (int64_t)length;
+    return str;
+}
+
+/* Accumulates a string of unknown length in runtime string storage. */
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} DSStringBuilder;
+
+static void ds_builder_append(DSStringBuilder *builder, const char *part) {
+    size_t n = strlen(part);
+    if (builder->length + n > builder->capacity) {
+        size_t grown = builder->capacity ? builder->capacity * 2 : 64;
+        while (grown < builder->length + n) grown *= 2;
+        char *next = ds_string_new(grown);
+        if (builder->length > 0) memcpy(next, builder->data, builder->length);
+        builder->data = next;
+        builder->capacity = grown;
+    }
+    memcpy(builder->data + builder->length, part, n);
+    builder->length += n;
+}
+
+static char *ds_builder_finish(DSStringBuilder *builder) {
+    return builder->data ? ds_string_truncate(builder->data, builder->length) : ds_string_new(0);
+}
+
+static size_t ds_string_length(const char *str) {
+    return (size_t)ds_string_header(str)->length;
+}
+
+/* Copies a C string the runtime did not build (a literal, argv, libc or io
+ * output) into a string value. */
 static char *ds_strdup(const char *input) {
     if (!input) return NULL;
-    size_t len = strlen(input);
-    char *copy = (char *)ds_alloc(len + 1);
-    memcpy(copy, input, len + 1);
-    return copy;
+    return ds_string_from(input, strlen(input));
+}
+
+/* Makes room for `count` items, doubling so repeated pushes stay linear. */
+static void ds_array_reserve(DSArray *array, int64_t count) {
+    int64_t capacity = array->capacity > array->length ? array->capacity : array->length;
+    if (count <= capacity && array->items) return;
+    int64_t grown = capacity ? capacity * 2 : 4;
+    while (grown < count) grown *= 2;
+    array->items = (void **)ds_realloc(array->items, sizeof(void *) * (size_t)array->length, sizeof(void *) * (size_t)grown, false);
+    array->capacity = grown;
 }
 
 static DSValue *ds_new_box(DSValueKind kind) {
@@ -234,12 +421,171 @@ static DSValue *ds_new_box(DSValueKind kind) {
     return value;
 }
 
+/* Integer and float boxes hold no pointers, so the collector never scans them. */
+static DSValue *ds_new_scalar_box(DSValueKind kind) {
+    DSValue *value = (DSValue *)ds_alloc_atomic(sizeof(DSValue));
+    value->magic = DS_BOX_MAGIC;
+    value->kind = kind;
+    value->as.i64 = 0;
+    return value;
+}
+
 static bool ds_is_boxed(void *value) {
     if (!value) return false;
     DSValue *box = (DSValue *)value;
     return box->magic == DS_BOX_MAGIC;
 }
 
+#define DS_MAP_MIN_INDEX 8
+
+static uint64_t ds_hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/* FNV-1a, with 0 reserved for "not computed yet" in string headers. The
+ * LLVM backend precomputes the same hash for string literals. */
+static uint64_t ds_hash_string(const char *str) {
+    DSStringHeader *header = ds_string_header(str);
+    if (header->hash) return header->hash;
+
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const char *cursor = str; *cursor; ++cursor) {
+        h ^= (unsigned char)*cursor;
+        h *= 0x100000001b3ULL;
+    }
+    if (!h) h = 1;
+    header->hash = h;
+    return h;
+}
+
+static bool ds_string_equal(const char *lhs, const char *rhs) {
+    if (lhs == rhs) return true;
+    if (!lhs || !rhs) return false;
+    DSStringHeader *lh = ds_string_header(lhs);
+    DSStringHeader *rh = ds_string_header(rhs);
+    if (lh->length != rh->length) return false;
+    if (lh->hash && rh->hash && lh->hash != rh->hash) return false;
+    return memcmp(lhs, rhs, (size_t)lh->length) == 0;
+}
+
+/* Must agree with dragonstone_runtime_case_compare: keys that compare equal
+ * hash equal. Kinds that only compare by identity hash the box itself. */
+static uint64_t ds_hash_key(void *key) {
+    if (!key) return 0;
+    if (!ds_is_boxed(key)) return ds_hash_string((const char *)key);
+
+    DSValue *box = (DSValue *)key;
+    uint64_t kind = (uint64_t)box->kind << 56;
+    switch (box->kind) {
+        case DS_VALUE_INT32: return ds_hash_mix(kind ^ (uint64_t)(int64_t)box->as.i32);
+        case DS_VALUE_INT64: return ds_hash_mix(kind ^ (uint64_t)box->as.i64);
+        case DS_VALUE_BOOL: return ds_hash_mix(kind ^ (uint64_t)box->as.boolean);
+        case DS_VALUE_FLOAT: {
+            double f = box->as.f64 == 0.0 ? 0.0 : box->as.f64;
+            uint64_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            return ds_hash_mix(kind ^ bits);
+        }
+        case DS_VALUE_ARRAY:
+        case DS_VALUE_INSTANCE:
+        case DS_VALUE_CLASS:
+        case DS_VALUE_MAP:
+            return ds_hash_mix(kind ^ (uint64_t)(uintptr_t)box->as.ptr);
+        case DS_VALUE_RANGE: {
+            DSRange *r = (DSRange *)box->as.ptr;
+            uint64_t h = ds_hash_mix(kind ^ (uint64_t)r->from);
+            h = ds_hash_mix(h ^ (uint64_t)r->to);
+            return h ^ (uint64_t)r->exclusive;
+        }
+        default:
+            return ds_hash_mix((uint64_t)(uintptr_t)key);
+    }
+}
+
+static DSMap *ds_map_new(int64_t capacity) {
+    DSMap *map = (DSMap *)ds_alloc(sizeof(DSMap));
+    map->entries = NULL;
+    map->count = 0;
+    map->capacity = 0;
+    map->index = NULL;
+    map->index_size = 0;
+    if (capacity > 0) {
+        map->entries = (DSMapEntry *)ds_alloc(sizeof(DSMapEntry) * (size_t)capacity);
+        map->capacity = capacity;
+    }
+    return map;
+}
+
+static void ds_map_index_insert(DSMap *map, int64_t position) {
+    uint64_t mask = (uint64_t)map->index_size - 1;
+    uint64_t bucket = map->entries[position].hash & mask;
+    while (map->index[bucket] >= 0) {
+        bucket = (bucket + 1) & mask;
+    }
+    map->index[bucket] = position;
+}
+
+/* Keeps the index at most half full so probe runs stay short. */
+static void ds_map_reserve(DSMap *map, int64_t count) {
+    if (count > map->capacity) {
+        int64_t capacity = map->capacity ? map->capacity : 4;
+        while (capacity < count) capacity *= 2;
+        map->entries = (DSMapEntry *)ds_realloc(map->entries, sizeof(DSMapEntry) * (size_t)map->count, sizeof(DSMapEntry) * (size_t)capacity, false);
+        map->capacity = capacity;
+    }
+
+    if (count * 2 > map->index_size) {
+        int64_t size = map->index_size ? map->index_size : DS_MAP_MIN_INDEX;
+        while (count * 2 > size) size *= 2;
+        map->index = (int64_t *)ds_alloc_atomic(sizeof(int64_t) * (size_t)size);
+        map->index_size = size;
+        for (int64_t i = 0; i < size; ++i) map->index[i] = -1;
+        for (int64_t i = 0; i < map->count; ++i) ds_map_index_insert(map, i);
+    }
+}
+
+static DSMapEntry *ds_map_find(DSMap *map, void *key) {
+    if (!map || map->count == 0) return NULL;
+    uint64_t hash = ds_hash_key(key);
+    uint64_t mask = (uint64_t)map->index_size - 1;
+    uint64_t bucket = hash & mask;
+    int64_t position;
+    while ((position = map->index[bucket]) >= 0) {
+        DSMapEntry *entry = &map->entries[position];
+        if (entry->hash == hash && dragonstone_runtime_case_compare(entry->key, key)) {
+            return entry;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+    return NULL;
+}
+
+/* Appends without checking for an existing key; callers that may repeat a
+ * key go through ds_map_set. */
+static void ds_map_append_entry(DSMap *map, void *key, void *value) {
+    ds_map_reserve(map, map->count + 1);
+    DSMapEntry *entry = &map->entries[map->count];
+    entry->key = key;
+    entry->value = value;
+    entry->hash = ds_hash_key(key);
+    ds_map_index_insert(map, map->count);
+    map->count++;
+}
+
+static void ds_map_set(DSMap *map, void *key, void *value) {
+    DSMapEntry *entry = ds_map_find(map, key);
+    if (entry) {
+        entry->value = value;
+        return;
+    }
+    ds_map_append_entry(map, key, value);
+}
+
 /* Forward decls used by ffi shims. */
 void *dragonstone_runtime_to_string(void *value);
 void *dragonstone_runtime_box_bool(int32_t value);
@@ -267,8 +613,7 @@ static bool ds_mkdirs(const char *path) {
     if (!path || !*path) return false;
 
     size_t len = strlen(path);
-    char *buf = (char *)ds_alloc(len + 1);
-    memcpy(buf, path, len + 1);
+    char *buf = ds_string_from(path, len);
 
     /* Normalize separators in-place. */
     for (size_t i = 0; i < len; i++) {
@@ -318,38 +663,36 @@ static DSArray *ds_unwrap_array(void *value) {
 }
 
 static char *ds_slice_string(const char *src, int64_t start, int64_t length) {
-    size_t slen = strlen(src);
+    size_t slen = ds_string_length(src);
     if (start < 0 || (size_t)start >= slen || length <= 0) {
         return ds_strdup("");
     }
     if ((size_t)(start + length) > slen) {
         length = (int64_t)(slen - (size_t)start);
     }
-    char *buf = (char *)ds_alloc((size_t)length + 1);
-    memcpy(buf, src + start, (size_t)length);
-    buf[length] = '\0';
-    return buf;
+    return ds_string_from(src + start, (size_t)length);
 }
 
 static char *ds_strip_string(const char *src) {
-    size_t len = strlen(src);
+    size_t len = ds_string_length(src);
     size_t start = 0;
     while (start < len && isspace((unsigned char)src[start])) start++;
     if (start == len) return ds_strdup("");
     size_t end = len;
     while (end > start && isspace((unsigned char)src[end - 1])) end--;
-    size_t out_len = end - start;
-    char *buf = (char *)ds_alloc(out_len + 1);
-    memcpy(buf, src + start, out_len);
-    buf[out_len] = '\0';
-    return buf;
+    return ds_string_from(src + start, end - start);
 }
 
 static char *ds_utf8_copy_range(const char *start, int len) {
-    char *buf = (char *)ds_alloc((size_t)len + 1);
-    memcpy(buf, start, (size_t)len);
-    buf[len] = '\0';
-    return buf;
+    return ds_string_from(start, (size_t)len);
+}
+
+/* utf8proc hands back malloc'd strings; copy them into collected memory. */
+static char *ds_adopt_string(utf8proc_uint8_t *mapped) {
+    if (!mapped) return ds_strdup("");
+    char *copy = ds_strdup((const char *)mapped);
+    free(mapped);
+    return copy;
 }
 
 static char *ds_unicode_normalize(const char *value, const char *form) {
@@ -365,15 +708,14 @@ static char *ds_unicode_normalize(const char *value, const char *form) {
     } else {
         mapped = utf8proc_NFC((const utf8proc_uint8_t *)value);
     }
-    if (!mapped) return ds_strdup("");
-    return (char *)mapped;
+    return ds_adopt_string(mapped);
 }
 
 static char *ds_unicode_map_case(const char *value, utf8proc_int32_t (*map_fn)(utf8proc_int32_t), bool ascii_only) {
     if (!value) return ds_strdup("");
     size_t len = strlen(value);
     size_t cap = len * 4 + 1;
-    utf8proc_uint8_t *buffer = (utf8proc_uint8_t *)ds_alloc(cap);
+    utf8proc_uint8_t *buffer = (utf8proc_uint8_t *)ds_alloc_atomic(cap);
     size_t offset = 0;
     size_t idx = 0;
 
@@ -392,16 +734,15 @@ static char *ds_unicode_map_case(const char *value, utf8proc_int32_t (*map_fn)(u
         utf8proc_ssize_t wrote = utf8proc_encode_char(mapped, tmp);
         if (wrote < 0) continue;
         if (offset + (size_t)wrote + 1 > cap) {
-            cap = cap * 2 + (size_t)wrote + 1;
-            buffer = (utf8proc_uint8_t *)realloc(buffer, cap);
-            if (!buffer) abort();
+            size_t grown = cap * 2 + (size_t)wrote + 1;
+            buffer = (utf8proc_uint8_t *)ds_realloc(buffer, offset, grown, true);
+            cap = grown;
         }
         memcpy(buffer + offset, tmp, (size_t)wrote);
         offset += (size_t)wrote;
     }
 
-    buffer[offset] = '\0';
-    return (char *)buffer;
+    return ds_string_from((const char *)buffer, offset);
 }
 
 static bool ds_unicode_ascii_only(const char *option) {
@@ -429,7 +770,7 @@ static char *ds_unicode_titlecase(const char *value, const char *option) {
     bool ascii_only = ds_unicode_ascii_only(option);
     size_t len = strlen(value);
     size_t cap = len * 4 + 1;
-    utf8proc_uint8_t *buffer = (utf8proc_uint8_t *)ds_alloc(cap);
+    utf8proc_uint8_t *buffer = (utf8proc_uint8_t *)ds_alloc_atomic(cap);
     size_t offset = 0;
     size_t idx = 0;
     bool first = true;
@@ -450,16 +791,15 @@ static char *ds_unicode_titlecase(const char *value, const char *option) {
         utf8proc_ssize_t wrote = utf8proc_encode_char(mapped, tmp);
         if (wrote < 0) continue;
         if (offset + (size_t)wrote + 1 > cap) {
-            cap = cap * 2 + (size_t)wrote + 1;
-            buffer = (utf8proc_uint8_t *)realloc(buffer, cap);
-            if (!buffer) abort();
+            size_t grown = cap * 2 + (size_t)wrote + 1;
+            buffer = (utf8proc_uint8_t *)ds_realloc(buffer, offset, grown, true);
+            cap = grown;
         }
         memcpy(buffer + offset, tmp, (size_t)wrote);
         offset += (size_t)wrote;
     }
 
-    buffer[offset] = '\0';
-    return (char *)buffer;
+    return ds_string_from((const char *)buffer, offset);
 }
 
 static char *ds_unicode_casefold(const char *value) {
@@ -467,8 +807,11 @@ static char *ds_unicode_casefold(const char *value) {
     utf8proc_uint8_t *mapped = NULL;
     utf8proc_option_t options = (utf8proc_option_t)(UTF8PROC_NULLTERM | UTF8PROC_STABLE | UTF8PROC_CASEFOLD);
     utf8proc_ssize_t rc = utf8proc_map((const utf8proc_uint8_t *)value, 0, &mapped, options);
-    if (rc < 0 || !mapped) return ds_strdup("");
-    return (char *)mapped;
+    if (rc < 0) {
+        free(mapped);
+        return ds_strdup("");
+    }
+    return ds_adopt_string(mapped);
 }
 
 static int64_t ds_unicode_grapheme_count(const char *value) {
@@ -503,7 +846,7 @@ static void *ds_unicode_graphemes(const char *value) {
     utf8proc_int32_t state = 0;
     bool has_prev = false;
 
-    int64_t *boundaries = (int64_t *)ds_alloc(sizeof(int64_t) * (len + 1));
+    int64_t *boundaries = (int64_t *)ds_alloc_atomic(sizeof(int64_t) * (len + 1));
     int64_t count = 0;
     boundaries[count++] = 0;
 
@@ -574,8 +917,10 @@ static void ds_constant_set(DSConstant **head, const char *name, void *value) {
         }
         curr = curr->next;
     }
+    ds_global_alloc_depth++;
     DSConstant *node = (DSConstant *)ds_alloc(sizeof(DSConstant));
     node->name = ds_strdup(name);
+    ds_global_alloc_depth--;
     node->value = value;
     node->next = *head;
     *head = node;
@@ -593,13 +938,13 @@ static void *ds_constant_get(DSConstant *head, const char *name) {
 }
 
 static char *ds_join_path(const char *lhs, const char *rhs) {
-    size_t len_l = strlen(lhs);
-    size_t len_r = strlen(rhs);
-    char *buffer = (char *)ds_alloc(len_l + len_r + 3);
+    size_t len_l = ds_string_length(lhs);
+    size_t len_r = ds_string_length(rhs);
+    char *buffer = ds_string_new(len_l + len_r + 2);
     memcpy(buffer, lhs, len_l);
     buffer[len_l] = ':';
     buffer[len_l + 1] = ':';
-    memcpy(buffer + len_l + 2, rhs, len_r + 1);
+    memcpy(buffer + len_l + 2, rhs, len_r);
     return buffer;
 }
 
@@ -641,17 +986,391 @@ void *dragonstone_runtime_pow(void *lhs, void *rhs);
 void *dragonstone_runtime_floor_div(void *lhs, void *rhs);
 void *dragonstone_runtime_cmp(void *lhs, void *rhs);
 
+static DSInstance *ds_instance_new(DSClass *cls) {
+    int64_t count = cls ? cls->ivar_count : 0;
+    DSInstance *inst = (DSInstance *)ds_alloc(sizeof(DSInstance) + (size_t)count * sizeof(void *));
+    inst->klass = cls;
+    inst->ivars = NULL;
+    inst->slot_count = count;
+    return inst;
+}
+
+/* One escape pass: the area being left and every allocation moved out of it
+ * so far, keyed by the address references into the area still hold. Escaping
+ * to the collected heap copies and frees the original, so a second reference
+ * to the same object (aliases, cycles) must resolve through this table rather
+ * than the area. The table itself lives in plain malloc memory for the pass. */
+typedef struct {
+    DragonstoneGcArea *area;
+    void **from;
+    void **to;
+    size_t size;
+    size_t count;
+} DSEscape;
+
+static size_t ds_escape_bucket(DSEscape *esc, void *ptr) {
+    size_t mask = esc->size - 1;
+    size_t bucket = (size_t)ds_hash_mix((uint64_t)(uintptr_t)ptr) & mask;
+    while (esc->from[bucket] && esc->from[bucket] != ptr) bucket = (bucket + 1) & mask;
+    return bucket;
+}
+
+static void *ds_escape_forwarded(DSEscape *esc, void *ptr) {
+    if (esc->count == 0) return NULL;
+    size_t bucket = ds_escape_bucket(esc, ptr);
+    return esc->from[bucket] ? esc->to[bucket] : NULL;
+}
+
+static void ds_escape_remember(DSEscape *esc, void *from, void *to) {
+    if ((esc->count + 1) * 2 > esc->size) {
+        DSEscape grown = *esc;
+        grown.size = esc->size ? esc->size * 2 : 64;
+        grown.count = 0;
+        grown.from = (void **)malloc(sizeof(void *) * grown.size);
+        grown.to = (void **)malloc(sizeof(void *) * grown.size);
+        if (!grown.from || !grown.to) ds_out_of_memory();
+        memset(grown.from, 0, sizeof(void *) * grown.size);
+        for (size_t i = 0; i < esc->size; ++i) {
+            if (!esc->from[i]) continue;
+            size_t bucket = ds_escape_bucket(&grown, esc->from[i]);
+            grown.from[bucket] = esc->from[i];
+            grown.to[bucket] = esc->to[i];
+            grown.count++;
+        }
+        free(esc->from);
+        free(esc->to);
+        *esc = grown;
+    }
+    size_t bucket = ds_escape_bucket(esc, from);
+    esc->from[bucket] = from;
+    esc->to[bucket] = to;
+    esc->count++;
+}
+
+/* Moves one allocation out of the area. `*seen` is set when an earlier
+ * reference already moved it, so its contents are (being) walked elsewhere. */
+static void *ds_escape_ptr(void *ptr, DSEscape *esc, bool *seen) {
+    *seen = false;
+    if (!ptr) return ptr;
+    void *known = ds_escape_forwarded(esc, ptr);
+    if (known) {
+        *seen = true;
+        return known;
+    }
+    if (!dragonstone_gc_is_in_area(ptr, esc->area)) return ptr;
+    void *moved = dragonstone_gc_escape(ptr);
+    ds_escape_remember(esc, ptr, moved);
+    return moved;
+}
+
+static void *ds_escape_value(void *value, DSEscape *esc);
+
+static void **ds_escape_items(void **items, int64_t length, DSEscape *esc) {
+    bool seen;
+    items = (void **)ds_escape_ptr(items, esc, &seen);
+    if (seen) return items;
+    for (int64_t i = 0; i < length; ++i) items[i] = ds_escape_value(items[i], esc);
+    return items;
+}
+
+/* Keys hashed by identity (arrays, instances, maps) hash a different address
+ * once moved, so the stored hashes and the index are rebuilt afterwards. */
+static DSMap *ds_escape_map(DSMap *map, DSEscape *esc) {
+    if (!map) return NULL;
+    bool seen;
+    map = (DSMap *)ds_escape_ptr(map, esc, &seen);
+    if (seen) return map;
+    map->entries = (DSMapEntry *)ds_escape_ptr(map->entries, esc, &seen);
+    map->index = (int64_t *)ds_escape_ptr(map->index, esc, &seen);
+    for (int64_t i = 0; i < map->count; ++i) {
+        map->entries[i].key = ds_escape_value(map->entries[i].key, esc);
+        map->entries[i].value = ds_escape_value(map->entries[i].value, esc);
+    }
+    for (int64_t i = 0; i < map->count; ++i) map->entries[i].hash = ds_hash_key(map->entries[i].key);
+    if (map->index) {
+        for (int64_t i = 0; i < map->index_size; ++i) map->index[i] = -1;
+        for (int64_t i = 0; i < map->count; ++i) ds_map_index_insert(map, i);
+    }
+    return map;
+}
+
+/* Moves a value allocated in `esc->area`, and whatever it references there,
+ * out to the parent area (or the collected heap). Anything already outside
+ * the area is shared as is. Block environments are not walked. Each box
+ * points at its moved payload before the payload is walked, so a cycle back
+ * to the box sees the final address. */
+static void *ds_escape_value(void *value, DSEscape *esc) {
+    if (!value) return value;
+    void *known = ds_escape_forwarded(esc, value);
+    if (known) return known;
+    if (!dragonstone_gc_is_in_area(value, esc->area)) {
+        /* A runtime string's allocation starts at its header, so the area
+         * tracks the header address rather than `value`. Membership comes
+         * from the area itself, which also makes reading the magic safe. */
+        DSStringHeader *header = (DSStringHeader *)((char *)value - sizeof(DSStringHeader));
+        if (!dragonstone_gc_is_in_area(header, esc->area) || header->magic != DS_STRING_MAGIC) return value;
+        void *moved = (DSStringHeader *)dragonstone_gc_escape(header) + 1;
+        ds_escape_remember(esc, value, moved);
+        return moved;
+    }
+    bool boxed = ds_is_boxed(value);
+    void *moved = dragonstone_gc_escape(value);
+    ds_escape_remember(esc, value, moved);
+    if (!boxed) return moved;
+
+    DSValue *box = (DSValue *)moved;
+    bool seen;
+    switch (box->kind) {
+        case DS_VALUE_ARRAY: {
+            DSArray *arr = (DSArray *)ds_escape_ptr(box->as.ptr, esc, &seen);
+            box->as.ptr = arr;
+            if (!seen) arr->items = ds_escape_items(arr->items, arr->length, esc);
+            break;
+        }
+        case DS_VALUE_TUPLE: {
+            DSTuple *tup = (DSTuple *)ds_escape_ptr(box->as.ptr, esc, &seen);
+            box->as.ptr = tup;
+            if (!seen) tup->items = ds_escape_items(tup->items, tup->length, esc);
+            break;
+        }
+        case DS_VALUE_NAMED_TUPLE: {
+            DSNamedTuple *nt = (DSNamedTuple *)ds_escape_ptr(box->as.ptr, esc, &seen);
+            box->as.ptr = nt;
+            if (!seen) {
+                nt->keys = (char **)ds_escape_items((void **)nt->keys, nt->length, esc);
+                nt->values = ds_escape_items(nt->values, nt->length, esc);
+            }
+            break;
+        }
+        case DS_VALUE_MAP:
+            box->as.ptr = ds_escape_map((DSMap *)box->as.ptr, esc);
+            break;
+        case DS_VALUE_INSTANCE: {
+            DSInstance *inst = (DSInstance *)ds_escape_ptr(box->as.ptr, esc, &seen);
+            box->as.ptr = inst;
+            if (!seen) {
+                inst->ivars = ds_escape_map(inst->ivars, esc);
+                for (int64_t i = 0; i < inst->slot_count; ++i) inst->slots[i] = ds_escape_value(inst->slots[i], esc);
+            }
+            break;
+        }
+        case DS_VALUE_BAG: {
+            DSBag *bag = (DSBag *)ds_escape_ptr(box->as.ptr, esc, &seen);
+            box->as.ptr = bag;
+            if (!seen && bag->items) {
+                bag->items = (DSArray *)ds_escape_ptr(bag->items, esc, &seen);
+                if (!seen) bag->items->items = ds_escape_items(bag->items->items, bag->items->length, esc);
+            }
+            break;
+        }
+        case DS_VALUE_BAG_CONSTRUCTOR: {
+            DSBagConstructor *ctor = (DSBagConstructor *)ds_escape_ptr(box->as.ptr, esc, &seen);
+            box->as.ptr = ctor;
+            if (!seen) ctor->element_type = (char *)ds_escape_value(ctor->element_type, esc);
+            break;
+        }
+        case DS_VALUE_STRUCT:
+        case DS_VALUE_RANGE:
+        case DS_VALUE_BLOCK:
+            box->as.ptr = ds_escape_ptr(box->as.ptr, esc, &seen);
+            break;
+        default:
+            break;
+    }
+    return box;
+}
+
+/* Called on the return value of @[Garbage(area, escape: return)] functions
+ * just before their area ends. */
+void *dragonstone_runtime_gc_escape(void *value) {
+    DragonstoneGcArea *area = dragonstone_gc_current_area();
+    if (!area) return value;
+    DSEscape esc = {area, NULL, NULL, 0, 0};
+    value = ds_escape_value(value, &esc);
+    free(esc.from);
+    free(esc.to);
+    return value;
+}
+
+NORETURN static void ds_uncaught_exception(void *message_ptr) {
+    const char *msg = (const char *)message_ptr;
+    fprintf(stderr, "Runtime Error: %s\n", msg ? msg : "Unknown error");
+    abort();
+}
+
+#if defined(_WIN32)
 void dragonstone_runtime_raise(void *message_ptr) {
     if (top_exception_frame) {
+        DSExceptionFrame *frame = top_exception_frame;
+        while (dragonstone_gc_current_area() && dragonstone_gc_current_area() != frame->area) {
+            message_ptr = dragonstone_runtime_gc_escape(message_ptr);
+            dragonstone_gc_end_area(dragonstone_gc_current_area());
+        }
+        while (dragonstone_gc_disable_depth() > frame->gc_disable_depth) dragonstone_gc_enable();
         current_exception_object = message_ptr;
-        longjmp(top_exception_frame->env, 1);
-    } else {
-        const char *msg = (const char *)message_ptr;
-        fprintf(stderr, "Runtime Error: %s\n", msg ? msg : "Unknown error");
-        abort();
+        longjmp(frame->env, 1);
+    }
+    ds_uncaught_exception(message_ptr);
+}
+#else
+static void ds_exception_cleanup(_Unwind_Reason_Code reason, struct _Unwind_Exception *header) {
+    (void)reason;
+    free(header);
+}
+
+void dragonstone_runtime_raise(void *message_ptr) {
+    /* malloc rather than the GC: the exception must survive the areas it
+     * unwinds through, and begin_catch frees it. */
+    DSException *ex = (DSException *)malloc(sizeof(DSException));
+    if (!ex) ds_out_of_memory();
+    memset(ex, 0, sizeof(DSException));
+    ex->header.exception_class = DS_EXCEPTION_CLASS;
+    ex->header.exception_cleanup = ds_exception_cleanup;
+    ex->payload = message_ptr;
+    /* Only returns when phase one found no handler; nothing has unwound yet. */
+    _Unwind_RaiseException(&ex->header);
+    free(ex);
+    ds_uncaught_exception(message_ptr);
+}
+
+/* Entry of a rescue landing pad: takes ownership of the in-flight exception
+ * and returns the raised value. */
+void *dragonstone_runtime_begin_catch(void *exception) {
+    DSException *ex = (DSException *)exception;
+    void *payload = ex->payload;
+    free(ex);
+    current_exception_object = payload;
+    return payload;
+}
+
+/* Cleanup pad of an @[Garbage(area)] function: the raised value is moved out
+ * of the area before the area is freed, as the setjmp path did. */
+void dragonstone_runtime_unwind_area(void *exception, void *area) {
+    DSException *ex = (DSException *)exception;
+    if (ex->header.exception_class == DS_EXCEPTION_CLASS) {
+        ex->payload = dragonstone_runtime_gc_escape(ex->payload);
     }
+    dragonstone_gc_end_area((DragonstoneGcArea *)area);
 }
 
+/* DWARF pointer encodings used by LLVM's LSDA. */
+enum {
+    DS_DW_EH_PE_absptr = 0x00,
+    DS_DW_EH_PE_uleb128 = 0x01,
+    DS_DW_EH_PE_udata2 = 0x02,
+    DS_DW_EH_PE_udata4 = 0x03,
+    DS_DW_EH_PE_udata8 = 0x04,
+    DS_DW_EH_PE_sleb128 = 0x09,
+    DS_DW_EH_PE_sdata2 = 0x0A,
+    DS_DW_EH_PE_sdata4 = 0x0B,
+    DS_DW_EH_PE_sdata8 = 0x0C,
+    DS_DW_EH_PE_pcrel = 0x10,
+    DS_DW_EH_PE_indirect = 0x80,
+    DS_DW_EH_PE_omit = 0xFF,
+};
+
+static uintptr_t ds_read_uleb128(const uint8_t **p) {
+    uintptr_t result = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+    do {
+        byte = *(*p)++;
+        result |= (uintptr_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return result;
+}
+
+static intptr_t ds_read_sleb128(const uint8_t **p) {
+    uintptr_t result = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+    do {
+        byte = *(*p)++;
+        result |= (uintptr_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    if ((byte & 0x40) && shift < sizeof(uintptr_t) * 8) {
+        result |= ~(uintptr_t)0 << shift;
+    }
+    return (intptr_t)result;
+}
+
+static uintptr_t ds_read_encoded(const uint8_t **p, uint8_t encoding) {
+    const uint8_t *start = *p;
+    uintptr_t result;
+    switch (encoding & 0x0F) {
+        case DS_DW_EH_PE_absptr: memcpy(&result, *p, sizeof(result)); *p += sizeof(result); break;
+        case DS_DW_EH_PE_uleb128: result = ds_read_uleb128(p); break;
+        case DS_DW_EH_PE_sleb128: result = (uintptr_t)ds_read_sleb128(p); break;
+        case DS_DW_EH_PE_udata2: { uint16_t v; memcpy(&v, *p, 2); *p += 2; result = v; break; }
+        case DS_DW_EH_PE_udata4: { uint32_t v; memcpy(&v, *p, 4); *p += 4; result = v; break; }
+        case DS_DW_EH_PE_udata8: { uint64_t v; memcpy(&v, *p, 8); *p += 8; result = (uintptr_t)v; break; }
+        case DS_DW_EH_PE_sdata2: { int16_t v; memcpy(&v, *p, 2); *p += 2; result = (uintptr_t)(intptr_t)v; break; }
+        case DS_DW_EH_PE_sdata4: { int32_t v; memcpy(&v, *p, 4); *p += 4; result = (uintptr_t)(intptr_t)v; break; }
+        case DS_DW_EH_PE_sdata8: { int64_t v; memcpy(&v, *p, 8); *p += 8; result = (uintptr_t)v; break; }
+        default: abort();
+    }
+    if (result && (encoding & 0x70) == DS_DW_EH_PE_pcrel) result += (uintptr_t)start;
+    if (result && (encoding & DS_DW_EH_PE_indirect)) result = *(uintptr_t *)result;
+    return result;
+}
+
+/* Personality for compiled Dragonstone functions. Every rescue landing pad is
+ * a catch-all (action != 0) and GC scope pads are cleanups (action == 0), so
+ * only the call-site table is consulted; the type table is never needed.
+ * Foreign exceptions pass through untouched. */
+_Unwind_Reason_Code dragonstone_runtime_personality(
+    int version,
+    _Unwind_Action actions,
+    uint64_t exception_class,
+    struct _Unwind_Exception *exception,
+    struct _Unwind_Context *context
+) {
+    if (version != 1) return _URC_FATAL_PHASE1_ERROR;
+    if (exception_class != DS_EXCEPTION_CLASS) return _URC_CONTINUE_UNWIND;
+
+    const uint8_t *lsda = (const uint8_t *)_Unwind_GetLanguageSpecificData(context);
+    if (!lsda) return _URC_CONTINUE_UNWIND;
+
+    uintptr_t func_start = _Unwind_GetRegionStart(context);
+    int ip_before = 0;
+    uintptr_t ip = _Unwind_GetIPInfo(context, &ip_before);
+    if (!ip_before) ip--;
+
+    uint8_t lp_start_encoding = *lsda++;
+    uintptr_t lp_start = lp_start_encoding == DS_DW_EH_PE_omit ? func_start : ds_read_encoded(&lsda, lp_start_encoding);
+    uint8_t ttype_encoding = *lsda++;
+    if (ttype_encoding != DS_DW_EH_PE_omit) ds_read_uleb128(&lsda);
+    uint8_t call_site_encoding = *lsda++;
+    uintptr_t table_length = ds_read_uleb128(&lsda);
+    const uint8_t *table_end = lsda + table_length;
+
+    while (lsda < table_end) {
+        uintptr_t start = ds_read_encoded(&lsda, call_site_encoding);
+        uintptr_t length = ds_read_encoded(&lsda, call_site_encoding);
+        uintptr_t landing_pad = ds_read_encoded(&lsda, call_site_encoding);
+        uintptr_t action = ds_read_uleb128(&lsda);
+
+        if (ip < func_start + start) break;
+        if (ip >= func_start + start + length) continue;
+        if (!landing_pad) return _URC_CONTINUE_UNWIND;
+
+        bool catches = action != 0;
+        if (actions & _UA_SEARCH_PHASE) {
+            return catches ? _URC_HANDLER_FOUND : _URC_CONTINUE_UNWIND;
+        }
+
+        _Unwind_SetGR(context, __builtin_eh_return_data_regno(0), (uintptr_t)exception);
+        _Unwind_SetGR(context, __builtin_eh_return_data_regno(1), catches ? 1 : 0);
+        _Unwind_SetIP(context, lp_start + landing_pad);
+        return _URC_INSTALL_CONTEXT;
+    }
+
+    return _URC_CONTINUE_UNWIND;
+}
+#endif
+
 static DSValue *ds_create_array_box(int64_t length, void **elements) {
     DSArray *array = (DSArray *)ds_alloc(sizeof(DSArray));
     array->length = length;
@@ -672,12 +1391,10 @@ static DSValue *ds_create_array_box(int64_t length, void **elements) {
 }
 
 static DSValue *ds_create_map_box(int64_t length, void **keys, void **values) {
-    DSMap *map = (DSMap *)ds_alloc(sizeof(DSMap));
-    map->head = NULL;
-    map->count = 0;
+    DSMap *map = ds_map_new(length);
 
     for (int64_t i = 0; i < length; ++i) {
-        ds_map_append_entry(map, keys[i], values[i]);
+        ds_map_set(map, keys[i], values[i]);
     }
 
     DSValue *box = ds_new_box(DS_VALUE_MAP);
@@ -685,10 +1402,38 @@ static DSValue *ds_create_map_box(int64_t length, void **keys, void **values) {
     return box;
 }
 
-void *dragonstone_runtime_box_i32(int32_t v) { DSValue *b = ds_new_box(DS_VALUE_INT32); b->as.i32 = v; return b; }
-void *dragonstone_runtime_box_i64(int64_t v) { DSValue *b = ds_new_box(DS_VALUE_INT64); b->as.i64 = v; return b; }
-void *dragonstone_runtime_box_bool(int32_t v) { DSValue *b = ds_new_box(DS_VALUE_BOOL); b->as.boolean = v; return b; }
-void *dragonstone_runtime_box_float(double v) { DSValue *b = ds_new_box(DS_VALUE_FLOAT); b->as.f64 = v; return b; }
+/* Immediate values. Boxes are never written after they are built, so the
+ * two booleans and the integers in [DS_SMALL_INT_MIN, DS_SMALL_INT_MAX] are
+ * shared static boxes and producing them does not allocate. Raw char*
+ * strings can sit at odd addresses, which rules out low-bit pointer tags. */
+#define DS_SMALL_INT_MIN (-1024)
+#define DS_SMALL_INT_MAX 32767
+
+static DSValue ds_true_box = { DS_BOX_MAGIC, DS_VALUE_BOOL, { .boolean = true } };
+static DSValue ds_false_box = { DS_BOX_MAGIC, DS_VALUE_BOOL, { .boolean = false } };
+static DSValue ds_small_ints[DS_SMALL_INT_MAX - DS_SMALL_INT_MIN + 1];
+
+static DSValue *ds_small_int(int64_t v) {
+    DSValue *box = &ds_small_ints[v - DS_SMALL_INT_MIN];
+    if (box->magic != DS_BOX_MAGIC) {
+        box->kind = DS_VALUE_INT64;
+        box->as.i64 = v;
+        box->magic = DS_BOX_MAGIC;
+    }
+    return box;
+}
+
+void *dragonstone_runtime_box_i32(int32_t v) { DSValue *b = ds_new_scalar_box(DS_VALUE_INT32); b->as.i32 = v; return b; }
+
+void *dragonstone_runtime_box_i64(int64_t v) {
+    if (v >= DS_SMALL_INT_MIN && v <= DS_SMALL_INT_MAX) return ds_small_int(v);
+    DSValue *b = ds_new_scalar_box(DS_VALUE_INT64);
+    b->as.i64 = v;
+    return b;
+}
+
+void *dragonstone_runtime_box_bool(int32_t v) { return v ? &ds_true_box : &ds_false_box; }
+void *dragonstone_runtime_box_float(double v) { DSValue *b = ds_new_scalar_box(DS_VALUE_FLOAT); b->as.f64 = v; return b; }
 void *dragonstone_runtime_box_string(void *v) { return v; }
 
 void* dragonstone_runtime_box_struct(void* data, int64_t size) {
@@ -736,7 +1481,7 @@ double dragonstone_runtime_unbox_float(void *v) {
 }
 
 static char *ds_format_value(void *value, bool quote_strings) {
-    if (!value) return (void *)DS_STR_NIL_VAL;
+    if (!value) return DS_STR_NIL_VAL.bytes;
     
     if (ds_is_boxed(value)) {
         DSValue *box = (DSValue *)value;
@@ -747,7 +1492,7 @@ static char *ds_format_value(void *value, bool quote_strings) {
             case DS_VALUE_INT64: {
                 char buf[64]; snprintf(buf, 64, "%lld", (long long)box->as.i64); return ds_strdup(buf);
             }
-            case DS_VALUE_BOOL: return (void*)(box->as.boolean ? DS_STR_TRUE_VAL : DS_STR_FALSE_VAL);
+            case DS_VALUE_BOOL: return box->as.boolean ? DS_STR_TRUE_VAL.bytes : DS_STR_FALSE_VAL.bytes;
             case DS_VALUE_FLOAT: {
                 char buf[64]; snprintf(buf, 64, "%g", box->as.f64); return ds_strdup(buf);
             }
@@ -758,34 +1503,30 @@ static char *ds_format_value(void *value, bool quote_strings) {
                 DSArray *arr = (DSArray *)box->as.ptr;
                 if (arr->length == 0) return ds_strdup("[]");
                 
-                char *buffer = (char *)ds_alloc(1024 * 16); 
-                strcpy(buffer, "[");
+                DSStringBuilder buffer = {0};
+                ds_builder_append(&buffer, "[");
                 for (int64_t i = 0; i < arr->length; ++i) {
-                    void *str_ptr = ds_format_value(arr->items[i], quote_strings);
-                    strcat(buffer, (char *)str_ptr);
-                    if (i < arr->length - 1) strcat(buffer, ", ");
+                    ds_builder_append(&buffer, ds_format_value(arr->items[i], quote_strings));
+                    if (i < arr->length - 1) ds_builder_append(&buffer, ", ");
                 }
-                strcat(buffer, "]");
-                return buffer;
+                ds_builder_append(&buffer, "]");
+                return ds_builder_finish(&buffer);
             }
             case DS_VALUE_MAP: {
                 DSMap *map = (DSMap *)box->as.ptr;
                 if (map->count == 0) return ds_strdup("{}");
                 
-                char *buffer = (char *)ds_alloc(1024 * 16);
-                strcpy(buffer, "{");
-                DSMapEntry *curr = map->head;
-                while (curr) {
-                    void *k_str = ds_format_value(curr->key, quote_strings);
-                    void *v_str = ds_format_value(curr->value, quote_strings);
-                    strcat(buffer, (char *)k_str);
-                    strcat(buffer, " -> ");
-                    strcat(buffer, (char *)v_str);
-                    if (curr->next) strcat(buffer, ", ");
-                    curr = curr->next;
+                DSStringBuilder buffer = {0};
+                ds_builder_append(&buffer, "{");
+                for (int64_t i = 0; i < map->count; i++) {
+                    DSMapEntry *curr = &map->entries[i];
+                    ds_builder_append(&buffer, ds_format_value(curr->key, quote_strings));
+                    ds_builder_append(&buffer, " -> ");
+                    ds_builder_append(&buffer, ds_format_value(curr->value, quote_strings));
+                    if (i < map->count - 1) ds_builder_append(&buffer, ", ");
                 }
-                strcat(buffer, "}");
-                return buffer;
+                ds_builder_append(&buffer, "}");
+                return ds_builder_finish(&buffer);
             }
             case DS_VALUE_BLOCK: return ds_strdup("{Block}");
             case DS_VALUE_RANGE: {
@@ -796,29 +1537,27 @@ static char *ds_format_value(void *value, bool quote_strings) {
             }
             case DS_VALUE_TUPLE: {
                 DSTuple *tup = (DSTuple *)box->as.ptr;
-                char *buffer = (char *)ds_alloc(1024 * 16);
-                strcpy(buffer, "{");
+                DSStringBuilder buffer = {0};
+                ds_builder_append(&buffer, "{");
                 for (int64_t i = 0; i < tup->length; ++i) {
-                    void *str_ptr = ds_format_value(tup->items[i], quote_strings);
-                    strcat(buffer, (char *)str_ptr);
-                    if (i < tup->length - 1) strcat(buffer, ", ");
+                    ds_builder_append(&buffer, ds_format_value(tup->items[i], quote_strings));
+                    if (i < tup->length - 1) ds_builder_append(&buffer, ", ");
                 }
-                strcat(buffer, "}");
-                return buffer;
+                ds_builder_append(&buffer, "}");
+                return ds_builder_finish(&buffer);
             }
             case DS_VALUE_NAMED_TUPLE: {
                 DSNamedTuple *nt = (DSNamedTuple *)box->as.ptr;
-                char *buffer = (char *)ds_alloc(1024 * 16);
-                strcpy(buffer, "{");
+                DSStringBuilder buffer = {0};
+                ds_builder_append(&buffer, "{");
                 for (int64_t i = 0; i < nt->length; ++i) {
-                    strcat(buffer, nt->keys[i]);
-                    strcat(buffer, ": ");
-                    void *str_ptr = ds_format_value(nt->values[i], quote_strings);
-                    strcat(buffer, (char *)str_ptr);
-                    if (i < nt->length - 1) strcat(buffer, ", ");
+                    ds_builder_append(&buffer, nt->keys[i]);
+                    ds_builder_append(&buffer, ": ");
+                    ds_builder_append(&buffer, ds_format_value(nt->values[i], quote_strings));
+                    if (i < nt->length - 1) ds_builder_append(&buffer, ", ");
                 }
-                strcat(buffer, "}");
-                return buffer;
+                ds_builder_append(&buffer, "}");
+                return ds_builder_finish(&buffer);
             }
             case DS_VALUE_ENUM: {
                 DSEnum *e = (DSEnum *)box->as.ptr;
@@ -827,9 +1566,9 @@ static char *ds_format_value(void *value, bool quote_strings) {
             case DS_VALUE_BAG_CONSTRUCTOR: {
                 DSBagConstructor *ctor = (DSBagConstructor *)box->as.ptr;
                 const char *etype = ctor && ctor->element_type ? ctor->element_type : "dynamic";
-                size_t len = strlen(etype) + 6;
-                char *buf = (char *)ds_alloc(len);
-                snprintf(buf, len, "bag(%s)", etype);
+                size_t len = strlen(etype) + 5;
+                char *buf = ds_string_new(len);
+                snprintf(buf, len + 1, "bag(%s)", etype);
                 return buf;
             }
             case DS_VALUE_BAG: {
@@ -842,11 +1581,10 @@ static char *ds_format_value(void *value, bool quote_strings) {
 
     if (quote_strings) {
         size_t len = strlen(str);
-        char *quoted = (char *)ds_alloc(len + 3);
+        char *quoted = ds_string_new(len + 2);
         quoted[0] = '"';
-        strcpy(quoted + 1, str);
+        memcpy(quoted + 1, str, len);
         quoted[len + 1] = '"';
-        quoted[len + 2] = '\0';
         return quoted;
     }
 
@@ -891,13 +1629,8 @@ void *dragonstone_runtime_array_push(void *array_val, void *value) {
         return array_val;
     }
     
-    int64_t new_len = array->length + 1;
-    void **new_items = (void **)realloc(array->items, sizeof(void *) * new_len);
-    if (!new_items) abort();
-    
-    array->items = new_items;
-    array->items[array->length] = value;
-    array->length = new_len;
+    ds_array_reserve(array, array->length + 1);
+    array->items[array->length++] = value;
     
     return array_val;
 }
@@ -945,25 +1678,222 @@ static void *ds_call_method(void *func_ptr, void *receiver, int64_t argc, void *
     return NULL;
 }
 
-static DSMethod *ds_lookup_method_from(DSClass *cls, const char *name) {
-    while (cls) {
-        DSMethod *meth = cls->methods;
-        while (meth) {
-            if (strcmp(meth->name, name) == 0) return meth;
-            meth = meth->next;
+/* Selectors: method names interned into dense integer ids. The generated
+ * code registers its selectors through dragonstone_runtime_intern_selectors
+ * at startup; the builtins below are interned first so the runtime can
+ * switch on them. */
+enum {
+    DS_SEL_NEW,
+    DS_SEL_INITIALIZE,
+    DS_SEL_CALL,
+    DS_SEL_PLUS,
+    DS_SEL_LENGTH,
+    DS_SEL_SIZE,
+    DS_SEL_EMPTY,
+    DS_SEL_EMPTY_Q,
+    DS_SEL_FIRST,
+    DS_SEL_LAST,
+    DS_SEL_PUSH,
+    DS_SEL_SHOVEL,
+    DS_SEL_POP,
+    DS_SEL_NIL_Q,
+    DS_SEL_BUILTIN_COUNT
+};
+
+static const char *ds_builtin_selector_names[DS_SEL_BUILTIN_COUNT] = {
+    "new", "initialize", "call", "+", "length", "size", "empty", "empty?",
+    "first", "last", "push", "<<", "pop", "nil?"
+};
+
+/* Set once a singleton method with this selector exists on anything other
+ * than a class object; such a method can shadow class and builtin methods
+ * for individual receivers, so dispatch must check singletons first. */
+#define DS_SEL_OBJECT_SINGLETON 0x1
+
+static DSMap *ds_selector_ids = NULL;
+static char **ds_selector_names = NULL;
+static DSSingletonMethod **ds_selector_singletons = NULL;
+static uint8_t *ds_selector_flags = NULL;
+static int64_t ds_selector_count = 0;
+static int64_t ds_selector_capacity = 0;
+
+/* Bumped whenever a method table, superclass link or singleton changes;
+ * class method tables and call-site caches are only valid for one epoch. */
+static uint64_t ds_method_epoch = 1;
+
+static int64_t ds_intern_selector(const char *name);
+
+static void ds_selectors_init(void) {
+    ds_global_alloc_depth++;
+    ds_selector_ids = ds_map_new(64);
+    ds_global_alloc_depth--;
+    for (int i = 0; i < DS_SEL_BUILTIN_COUNT; ++i) {
+        ds_intern_selector(ds_builtin_selector_names[i]);
+    }
+}
+
+static int64_t ds_intern_selector(const char *name) {
+    if (!ds_selector_ids) ds_selectors_init();
+    if (!name) name = "";
+
+    DSMapEntry *entry = ds_map_find(ds_selector_ids, (void *)name);
+    if (entry) return (int64_t)(intptr_t)entry->value;
+
+    ds_global_alloc_depth++;
+    if (ds_selector_count == ds_selector_capacity) {
+        int64_t capacity = ds_selector_capacity ? ds_selector_capacity * 2 : 64;
+        size_t used = (size_t)ds_selector_count;
+        ds_selector_names = (char **)ds_realloc(ds_selector_names, sizeof(char *) * used, sizeof(char *) * (size_t)capacity, false);
+        ds_selector_singletons = (DSSingletonMethod **)ds_realloc(ds_selector_singletons, sizeof(DSSingletonMethod *) * used, sizeof(DSSingletonMethod *) * (size_t)capacity, false);
+        ds_selector_flags = (uint8_t *)ds_realloc(ds_selector_flags, used, (size_t)capacity, true);
+        ds_selector_capacity = capacity;
+    }
+
+    int64_t id = ds_selector_count++;
+    char *copy = ds_strdup(name);
+    ds_selector_names[id] = copy;
+    ds_selector_singletons[id] = NULL;
+    ds_selector_flags[id] = 0;
+    ds_map_append_entry(ds_selector_ids, copy, (void *)(intptr_t)id);
+    ds_global_alloc_depth--;
+    return id;
+}
+
+void dragonstone_runtime_intern_selectors(int64_t count, char **names, int64_t **slots) {
+    for (int64_t i = 0; i < count; ++i) {
+        *slots[i] = ds_intern_selector(names[i]);
+    }
+}
+
+static void ds_method_table_insert(DSClass *cls, int64_t selector, DSMethod *method) {
+    if ((cls->mtable_count + 1) * 2 > cls->mtable_size) {
+        int64_t size = cls->mtable_size ? cls->mtable_size * 2 : 16;
+        DSMethodSlot *old = cls->mtable;
+        int64_t old_size = cls->mtable_size;
+        ds_global_alloc_depth++;
+        cls->mtable = (DSMethodSlot *)ds_alloc(sizeof(DSMethodSlot) * (size_t)size);
+        ds_global_alloc_depth--;
+        cls->mtable_size = size;
+        cls->mtable_count = 0;
+        for (int64_t i = 0; i < size; ++i) cls->mtable[i].selector = -1;
+        for (int64_t i = 0; i < old_size; ++i) {
+            if (old[i].selector >= 0) ds_method_table_insert(cls, old[i].selector, old[i].method);
         }
-        cls = cls->superclass;
     }
-    return NULL;
+
+    uint64_t mask = (uint64_t)cls->mtable_size - 1;
+    uint64_t bucket = ds_hash_mix((uint64_t)selector) & mask;
+    while (cls->mtable[bucket].selector >= 0) {
+        bucket = (bucket + 1) & mask;
+    }
+    cls->mtable[bucket].selector = selector;
+    cls->mtable[bucket].method = method;
+    cls->mtable_count++;
 }
 
-void dragonstone_runtime_define_singleton_method(void *receiver, void *name_ptr, void *func_ptr) {
+/* Resolves `selector` against `cls` and its superclasses, memoising the
+ * result (including misses) in the class's method table. */
+static DSMethod *ds_lookup_selector(DSClass *cls, int64_t selector) {
+    if (!cls) return NULL;
+
+    if (cls->mtable_epoch != ds_method_epoch) {
+        for (int64_t i = 0; i < cls->mtable_size; ++i) cls->mtable[i].selector = -1;
+        cls->mtable_count = 0;
+        cls->mtable_epoch = ds_method_epoch;
+    }
+
+    if (cls->mtable_count > 0) {
+        uint64_t mask = (uint64_t)cls->mtable_size - 1;
+        uint64_t bucket = ds_hash_mix((uint64_t)selector) & mask;
+        while (cls->mtable[bucket].selector >= 0) {
+            if (cls->mtable[bucket].selector == selector) return cls->mtable[bucket].method;
+            bucket = (bucket + 1) & mask;
+        }
+    }
+
+    DSMethod *found = NULL;
+    for (DSClass *curr = cls; curr && !found; curr = curr->superclass) {
+        for (DSMethod *meth = curr->methods; meth; meth = meth->next) {
+            if (meth->selector == selector) {
+                found = meth;
+                break;
+            }
+        }
+    }
+
+    ds_method_table_insert(cls, selector, found);
+    return found;
+}
+
+static DSMethod *ds_lookup_method_from(DSClass *cls, const char *name) {
+    if (!cls) return NULL;
+    return ds_lookup_selector(cls, ds_intern_selector(name));
+}
+
+static DSMethod *ds_new_method(const char *name, void *func_ptr, bool expects_block) {
+    ds_global_alloc_depth++;
+    DSMethod *m = (DSMethod *)ds_alloc(sizeof(DSMethod));
+    m->name = ds_strdup(name);
+    ds_global_alloc_depth--;
+    m->selector = ds_intern_selector(name);
+    m->func_ptr = func_ptr;
+    m->expects_block = expects_block;
+    return m;
+}
+
+static void ds_add_singleton_method(void *receiver, const char *name, void *func_ptr) {
+    ds_global_alloc_depth++;
     DSSingletonMethod *node = (DSSingletonMethod *)ds_alloc(sizeof(DSSingletonMethod));
     node->receiver = receiver;
-    node->name = ds_strdup((char *)name_ptr);
+    node->name = ds_strdup(name);
+    ds_global_alloc_depth--;
+    node->selector = ds_intern_selector(name);
     node->func_ptr = func_ptr;
     node->next = singleton_methods;
     singleton_methods = node;
+    node->next_same = ds_selector_singletons[node->selector];
+    ds_selector_singletons[node->selector] = node;
+
+    if (!ds_is_boxed(receiver) || ((DSValue *)receiver)->kind != DS_VALUE_CLASS) {
+        ds_selector_flags[node->selector] |= DS_SEL_OBJECT_SINGLETON;
+    }
+    ds_method_epoch++;
+}
+
+static DSSingletonMethod *ds_find_singleton_method(void *receiver, int64_t selector) {
+    bool boxed = ds_is_boxed(receiver);
+    for (DSSingletonMethod *node = ds_selector_singletons[selector]; node; node = node->next_same) {
+        if (node->receiver == receiver) return node;
+        if (!boxed && node->receiver && !ds_is_boxed(node->receiver) && strcmp((char *)node->receiver, (char *)receiver) == 0) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+/* Calls a class method, appending the block to argv when it expects one. */
+static void *ds_invoke_method(void *func_ptr, bool expects_block, void *receiver, int64_t argc, void **argv, void *block_val) {
+    if (!expects_block) return ds_call_method(func_ptr, receiver, argc, argv);
+
+    int64_t argc2 = argc + 1;
+    void *stack_args[8];
+    void **argv2 = NULL;
+
+    if (argc2 <= 8) {
+        for (int64_t i = 0; i < argc; i++) stack_args[i] = argv[i];
+        stack_args[argc] = block_val;
+        argv2 = stack_args;
+    } else {
+        argv2 = (void **)ds_alloc(sizeof(void*) * (size_t)argc2);
+        for (int64_t i = 0; i < argc; i++) argv2[i] = argv[i];
+        argv2[argc] = block_val;
+    }
+
+    return ds_call_method(func_ptr, receiver, argc2, argv2);
+}
+
+void dragonstone_runtime_define_singleton_method(void *receiver, void *name_ptr, void *func_ptr) {
+    ds_add_singleton_method(receiver, (const char *)name_ptr, func_ptr);
 }
 
 static int64_t ds_get_ordinal(void *val, bool *is_char) {
@@ -986,8 +1916,7 @@ static int64_t ds_get_ordinal(void *val, bool *is_char) {
     return 0;
 }
 
-void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, int64_t argc, void **argv, void *block_val) {
-    const char *method = (const char *)method_name_ptr;
+static void *ds_dispatch(void *receiver, const char *method, int64_t selector, int64_t argc, void **argv, void *block_val) {
 
     if (receiver && !ds_is_boxed(receiver)) {
         const char *recv_str = (const char *)receiver;
@@ -1022,11 +1951,10 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                         long size = ftell(fp);
                         fseek(fp, 0, SEEK_SET);
                         if (size < 0) { fclose(fp); return ds_strdup(""); }
-                        char *buf = (char *)ds_alloc((size_t)size + 1);
+                        char *buf = ds_string_new((size_t)size);
                         size_t got = fread(buf, 1, (size_t)size, fp);
-                        buf[got] = '\0';
                         fclose(fp);
-                        return buf;
+                        return ds_string_truncate(buf, got);
                     }
 
                     if ((strcmp(fn, "file_write") == 0 || strcmp(fn, "file_append") == 0 || strcmp(fn, "file_create") == 0) && args->length >= 2) {
@@ -1041,10 +1969,7 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                             if (last_bslash && (!sep || last_bslash > sep)) sep = last_bslash;
                             if (sep) {
                                 size_t dlen = (size_t)(sep - path);
-                                char *dir = (char *)ds_alloc(dlen + 1);
-                                memcpy(dir, path, dlen);
-                                dir[dlen] = '\0';
-                                ds_mkdirs(dir);
+                                ds_mkdirs(ds_string_from(path, dlen));
                             }
                         }
 
@@ -1083,10 +2008,7 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                             if (last_bslash && (!sep || last_bslash > sep)) sep = last_bslash;
                             if (sep) {
                                 size_t dlen = (size_t)(sep - path);
-                                char *dir = (char *)ds_alloc(dlen + 1);
-                                memcpy(dir, path, dlen);
-                                dir[dlen] = '\0';
-                                ds_mkdirs(dir);
+                                ds_mkdirs(ds_string_from(path, dlen));
                             }
                         }
 
@@ -1241,17 +2163,9 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
         return NULL;
     }
 
-    DSSingletonMethod *snode = singleton_methods;
-    while (snode) {
-        if (strcmp(snode->name, method) == 0) {
-            if (snode->receiver == receiver) {
-                return ds_call_method(snode->func_ptr, receiver, argc, argv);
-            }
-            if (!ds_is_boxed(receiver) && !ds_is_boxed(snode->receiver) && strcmp((char *)snode->receiver, (char *)receiver) == 0) {
-                return ds_call_method(snode->func_ptr, receiver, argc, argv);
-            }
-        }
-        snode = snode->next;
+    DSSingletonMethod *snode = ds_find_singleton_method(receiver, selector);
+    if (snode) {
+        return ds_call_method(snode->func_ptr, receiver, argc, argv);
     }
 
     if (ds_is_boxed(receiver) && ((DSValue*)receiver)->kind == DS_VALUE_ENUM) {
@@ -1265,7 +2179,7 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
         char *str = (char *)receiver;
         
         if (strcmp(method, "length") == 0 || strcmp(method, "size") == 0) {
-            return dragonstone_runtime_box_i64(strlen(str));
+            return dragonstone_runtime_box_i64((int64_t)ds_string_length(str));
         }
         
         if (strcmp(method, "upcase") == 0) {
@@ -1393,12 +2307,8 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                     return receiver;
                 }
             }
-            int64_t new_len = arr->length + 1;
-            void **new_items = (void **)realloc(arr->items, sizeof(void*) * new_len);
-            if (!new_items) abort();
-            arr->items = new_items;
-            arr->items[arr->length] = val;
-            arr->length = new_len;
+            ds_array_reserve(arr, arr->length + 1);
+            arr->items[arr->length++] = val;
             return receiver;
         }
 
@@ -1421,7 +2331,6 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                 items[i] = dragonstone_runtime_block_invoke(block_val, 1, args_buf);
             }
             void *res = dragonstone_runtime_array_literal(arr->length, items);
-            free(items);
             return res;
         }
 
@@ -1436,12 +2345,8 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                 args_buf[0] = arr->items[i];
                 void *res = dragonstone_runtime_block_invoke(block_val, 1, args_buf);
                 if (dragonstone_runtime_case_compare(res, dragonstone_runtime_box_bool(true))) {
-                    int64_t new_len = out->items->length + 1;
-                    void **new_items = (void **)realloc(out->items->items, sizeof(void*) * new_len);
-                    if (!new_items) abort();
-                    out->items->items = new_items;
-                    out->items->items[out->items->length] = arr->items[i];
-                    out->items->length = new_len;
+                    ds_array_reserve(out->items, out->items->length + 1);
+                    out->items->items[out->items->length++] = arr->items[i];
                 }
             }
             DSValue *box_out = ds_new_box(DS_VALUE_BAG);
@@ -1483,14 +2388,13 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
             void **items = (void **)ds_alloc(sizeof(void*) * arr->length);
             for (int64_t i = 0; i < arr->length; i++) items[i] = arr->items[i];
             void *res = dragonstone_runtime_array_literal(arr->length, items);
-            free(items);
             return res;
         }
     }
 
     if (box->kind == DS_VALUE_CLASS) {
         DSClass *cls = (DSClass *)box->as.ptr;
-        if (strcmp(method, "new") == 0 && !cls->is_module) {
+        if (selector == DS_SEL_NEW && !cls->is_module) {
             /* Enum-style constructor: match by value if enum members exist. */
             if (argc == 1) {
                 int64_t target = dragonstone_runtime_unbox_i64(argv[0]);
@@ -1506,37 +2410,17 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                 }
             }
 
-            DSInstance *inst = (DSInstance *)ds_alloc(sizeof(DSInstance));
-            inst->klass = cls;
-            inst->ivars = NULL;
+            DSInstance *inst = ds_instance_new(cls);
             DSValue *inst_box = ds_new_box(DS_VALUE_INSTANCE);
             inst_box->as.ptr = inst;
-            DSMethod *init = ds_lookup_method_from(cls, "initialize");
+            DSMethod *init = ds_lookup_selector(cls, DS_SEL_INITIALIZE);
             if (init) ds_call_method(init->func_ptr, inst_box, argc, argv);
             
             return inst_box;
         }
-        DSMethod *meth = ds_lookup_method_from(cls, method);
+        DSMethod *meth = ds_lookup_selector(cls, selector);
         if (meth) {
-            if (meth->expects_block) {
-                int64_t argc2 = argc + 1;
-                void *stack_args[8];
-                void **argv2 = NULL;
-
-                if (argc2 <= 8) {
-                    for (int64_t i = 0; i < argc; i++) stack_args[i] = argv[i];
-                    stack_args[argc] = block_val;
-                    argv2 = stack_args;
-                } else {
-                    argv2 = (void **)ds_alloc(sizeof(void*) * (size_t)argc2);
-                    for (int64_t i = 0; i < argc; i++) argv2[i] = argv[i];
-                    argv2[argc] = block_val;
-                }
-
-                return ds_call_method(meth->func_ptr, receiver, argc2, argv2);
-            }
-
-            return ds_call_method(meth->func_ptr, receiver, argc, argv);
+            return ds_invoke_method(meth->func_ptr, meth->expects_block, receiver, argc, argv, block_val);
         }
         if (strcmp(method, "each") == 0 && block_val) {
             DSConstant *curr = cls->constants;
@@ -1553,27 +2437,9 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
     if (box->kind == DS_VALUE_INSTANCE) {
         DSInstance *inst = (DSInstance *)box->as.ptr;
         DSClass *cls = inst->klass;
-        DSMethod *curr = ds_lookup_method_from(cls, method);
+        DSMethod *curr = ds_lookup_selector(cls, selector);
         if (curr) {
-            if (curr->expects_block) {
-                int64_t argc2 = argc + 1;
-                void *stack_args[8];
-                void **argv2 = NULL;
-
-                if (argc2 <= 8) {
-                    for (int64_t i = 0; i < argc; i++) stack_args[i] = argv[i];
-                    stack_args[argc] = block_val;
-                    argv2 = stack_args;
-                } else {
-                    argv2 = (void **)ds_alloc(sizeof(void*) * (size_t)argc2);
-                    for (int64_t i = 0; i < argc; i++) argv2[i] = argv[i];
-                    argv2[argc] = block_val;
-                }
-
-                return ds_call_method(curr->func_ptr, receiver, argc2, argv2);
-            }
-
-            return ds_call_method(curr->func_ptr, receiver, argc, argv);
+            return ds_invoke_method(curr->func_ptr, curr->expects_block, receiver, argc, argv, block_val);
         }
     }
 
@@ -1617,7 +2483,6 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                 }
             }
             void *res = dragonstone_runtime_array_literal(count, items);
-            free(items);
             return res;
         }
         if (strcmp(method, "inject") == 0) {
@@ -1659,49 +2524,39 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
         
         if (strcmp(method, "keys") == 0) {
             void **buf = (void **)ds_alloc(sizeof(void*) * map->count);
-            DSMapEntry *curr = map->head;
-            int64_t i = 0;
-            while (curr) { buf[i++] = curr->key; curr = curr->next; }
+            for (int64_t i = 0; i < map->count; i++) buf[i] = map->entries[i].key;
             void *res = dragonstone_runtime_array_literal(map->count, buf);
-            free(buf);
             return res;
         }
         if (strcmp(method, "values") == 0) {
             void **buf = (void **)ds_alloc(sizeof(void*) * map->count);
-            DSMapEntry *curr = map->head;
-            int64_t i = 0;
-            while (curr) { buf[i++] = curr->value; curr = curr->next; }
+            for (int64_t i = 0; i < map->count; i++) buf[i] = map->entries[i].value;
             void *res = dragonstone_runtime_array_literal(map->count, buf);
-            free(buf);
             return res;
         }
         if (strcmp(method, "each") == 0) {
             if (!block_val) return receiver;
             void *args[2];
-            DSMapEntry *curr = map->head;
-            while (curr) {
-                args[0] = curr->key;
-                args[1] = curr->value;
+            for (int64_t i = 0; i < map->count; i++) {
+                args[0] = map->entries[i].key;
+                args[1] = map->entries[i].value;
                 dragonstone_runtime_block_invoke(block_val, 2, args);
-                curr = curr->next;
             }
             return receiver;
         }
         if (strcmp(method, "select") == 0) {
             if (!block_val) return receiver;
-            DSMap *out = (DSMap *)ds_alloc(sizeof(DSMap));
-            out->head = NULL;
-            out->count = 0;
-            DSMapEntry *curr = map->head;
+            DSMap *out = ds_map_new(0);
             void *args[2];
-            while (curr) {
-                args[0] = curr->key;
-                args[1] = curr->value;
+            for (int64_t i = 0; i < map->count; i++) {
+                void *key = map->entries[i].key;
+                void *value = map->entries[i].value;
+                args[0] = key;
+                args[1] = value;
                 void *res = dragonstone_runtime_block_invoke(block_val, 2, args);
                 if (dragonstone_runtime_case_compare(res, dragonstone_runtime_box_bool(true))) {
-                    ds_map_append_entry(out, curr->key, curr->value);
+                    ds_map_append_entry(out, key, value);
                 }
-                curr = curr->next;
             }
             DSValue *box_out = ds_new_box(DS_VALUE_MAP);
             box_out->as.ptr = out;
@@ -1711,37 +2566,34 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
             if (!block_val) return receiver;
             if (argc > 1) return receiver;
             void *memo = argc == 1 ? argv[0] : NULL;
-            DSMapEntry *curr = map->head;
             void *args[3];
-            while (curr) {
+            for (int64_t i = 0; i < map->count; i++) {
                 if (memo == NULL && argc == 0) {
-                    memo = curr->value;
-                    curr = curr->next;
+                    memo = map->entries[i].value;
                     continue;
                 }
                 args[0] = memo;
-                args[1] = curr->key;
-                args[2] = curr->value;
+                args[1] = map->entries[i].key;
+                args[2] = map->entries[i].value;
                 memo = dragonstone_runtime_block_invoke(block_val, 3, args);
-                curr = curr->next;
             }
             return memo;
         }
         if (strcmp(method, "until") == 0) {
             if (!block_val) return receiver;
             void *args[2];
-            DSMapEntry *curr = map->head;
-            while (curr) {
-                args[0] = curr->key;
-                args[1] = curr->value;
+            for (int64_t i = 0; i < map->count; i++) {
+                void *key = map->entries[i].key;
+                void *value = map->entries[i].value;
+                args[0] = key;
+                args[1] = value;
                 void *res = dragonstone_runtime_block_invoke(block_val, 2, args);
                 if (dragonstone_runtime_case_compare(res, dragonstone_runtime_box_bool(true))) {
                     void **items = (void **)ds_alloc(sizeof(void*) * 2);
-                    items[0] = curr->key;
-                    items[1] = curr->value;
+                    items[0] = key;
+                    items[1] = value;
                     return dragonstone_runtime_tuple_literal(2, items);
                 }
-                curr = curr->next;
             }
             return NULL;
         }
@@ -1822,7 +2674,6 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
                 }
             }
             void *res = dragonstone_runtime_array_literal(count, items);
-            free(items);
             return res;
         }
     }
@@ -1831,7 +2682,165 @@ void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, i
     return NULL;
 }
 
-void *dragonstone_runtime_define_class(void *name_ptr) {
+void *dragonstone_runtime_method_invoke(void *receiver, void *method_name_ptr, int64_t argc, void **argv, void *block_val) {
+    const char *method = (const char *)method_name_ptr;
+    return ds_dispatch(receiver, method, ds_intern_selector(method), argc, argv, block_val);
+}
+
+/* Hot builtin methods, dispatched on receiver kind and selector. Returns
+ * true and sets *result when the call was handled. */
+static bool ds_dispatch_builtin(void *receiver, int64_t selector, int64_t argc, void **argv, void *block_val, void **result) {
+    if (!ds_is_boxed(receiver)) {
+        switch (selector) {
+            case DS_SEL_LENGTH:
+            case DS_SEL_SIZE:
+                *result = dragonstone_runtime_box_i64((int64_t)ds_string_length((const char *)receiver));
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    DSValue *box = (DSValue *)receiver;
+    switch (box->kind) {
+        case DS_VALUE_ARRAY: {
+            DSArray *arr = (DSArray *)box->as.ptr;
+            switch (selector) {
+                case DS_SEL_LENGTH:
+                case DS_SEL_SIZE:
+                    *result = dragonstone_runtime_box_i64(arr->length);
+                    return true;
+                case DS_SEL_EMPTY:
+                case DS_SEL_EMPTY_Q:
+                    *result = dragonstone_runtime_box_bool(arr->length == 0);
+                    return true;
+                case DS_SEL_FIRST:
+                    *result = arr->length > 0 ? arr->items[0] : NULL;
+                    return true;
+                case DS_SEL_LAST:
+                    *result = arr->length > 0 ? arr->items[arr->length - 1] : NULL;
+                    return true;
+                case DS_SEL_POP:
+                    *result = NULL;
+                    if (arr->length > 0) *result = arr->items[--arr->length];
+                    return true;
+                case DS_SEL_PUSH:
+                case DS_SEL_SHOVEL:
+                    if (argc > 0) dragonstone_runtime_array_push(receiver, argv[0]);
+                    *result = receiver;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        case DS_VALUE_MAP: {
+            DSMap *map = (DSMap *)box->as.ptr;
+            switch (selector) {
+                case DS_SEL_LENGTH:
+                case DS_SEL_SIZE:
+                    *result = dragonstone_runtime_box_i64(map->count);
+                    return true;
+                case DS_SEL_EMPTY:
+                case DS_SEL_EMPTY_Q:
+                    *result = dragonstone_runtime_box_bool(map->count == 0);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        case DS_VALUE_TUPLE: {
+            DSTuple *tup = (DSTuple *)box->as.ptr;
+            switch (selector) {
+                case DS_SEL_LENGTH:
+                case DS_SEL_SIZE:
+                    *result = dragonstone_runtime_box_i64(tup->length);
+                    return true;
+                case DS_SEL_FIRST:
+                    *result = tup->length > 0 ? tup->items[0] : NULL;
+                    return true;
+                case DS_SEL_LAST:
+                    *result = tup->length > 0 ? tup->items[tup->length - 1] : NULL;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        case DS_VALUE_BAG: {
+            DSArray *arr = ((DSBag *)box->as.ptr)->items;
+            switch (selector) {
+                case DS_SEL_LENGTH:
+                case DS_SEL_SIZE:
+                    *result = dragonstone_runtime_box_i64(arr->length);
+                    return true;
+                case DS_SEL_EMPTY:
+                case DS_SEL_EMPTY_Q:
+                    *result = dragonstone_runtime_box_bool(arr->length == 0);
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        case DS_VALUE_BLOCK:
+            if (selector != DS_SEL_CALL) return false;
+            *result = dragonstone_runtime_block_invoke(receiver, argc, argv);
+            return true;
+        default:
+            (void)block_val;
+            return false;
+    }
+}
+
+/* Entry point for compiled method calls. `selector` comes from the table the
+ * program registered at startup and `cache` is the call site's own inline
+ * cache; anything the fast paths cannot settle goes through ds_dispatch. */
+void *dragonstone_runtime_send(void *receiver, int64_t selector, DSCallCache *cache, int64_t argc, void **argv, void *block_val) {
+    if (!receiver) {
+        return selector == DS_SEL_NIL_Q ? dragonstone_runtime_box_bool(true) : NULL;
+    }
+
+    bool object_singletons = (ds_selector_flags[selector] & DS_SEL_OBJECT_SINGLETON) != 0;
+
+    if (ds_is_boxed(receiver)) {
+        DSValue *box = (DSValue *)receiver;
+        if (box->kind == DS_VALUE_INSTANCE) {
+            DSClass *cls = ((DSInstance *)box->as.ptr)->klass;
+            if (cache->epoch == ds_method_epoch && cache->klass == cls) {
+                return ds_invoke_method(cache->func_ptr, cache->expects_block != 0, receiver, argc, argv, block_val);
+            }
+            if (!object_singletons) {
+                DSMethod *meth = ds_lookup_selector(cls, selector);
+                if (meth) {
+                    cache->klass = cls;
+                    cache->func_ptr = meth->func_ptr;
+                    cache->expects_block = meth->expects_block;
+                    cache->epoch = ds_method_epoch;
+                    return ds_invoke_method(meth->func_ptr, meth->expects_block, receiver, argc, argv, block_val);
+                }
+            }
+        } else if (box->kind == DS_VALUE_CLASS) {
+            if (cache->epoch == ds_method_epoch && cache->klass == receiver) {
+                return ds_call_method(cache->func_ptr, receiver, argc, argv);
+            }
+            DSSingletonMethod *snode = ds_find_singleton_method(receiver, selector);
+            if (snode) {
+                cache->klass = receiver;
+                cache->func_ptr = snode->func_ptr;
+                cache->expects_block = 0;
+                cache->epoch = ds_method_epoch;
+                return ds_call_method(snode->func_ptr, receiver, argc, argv);
+            }
+        }
+    }
+
+    if (!object_singletons) {
+        void *result = NULL;
+        if (ds_dispatch_builtin(receiver, selector, argc, argv, block_val, &result)) return result;
+    }
+
+    return ds_dispatch(receiver, ds_selector_names[selector], selector, argc, argv, block_val);
+}
+
+static void *ds_define_class(void *name_ptr) {
     const char *name = (const char *)name_ptr;
     DSClass *curr = global_classes;
     while (curr) {
@@ -1862,7 +2871,7 @@ void *dragonstone_runtime_define_class(void *name_ptr) {
     return box;
 }
 
-void *dragonstone_runtime_define_module(void *name_ptr) {
+static void *ds_define_module(void *name_ptr) {
     const char *name = (const char *)name_ptr;
     DSClass *curr = global_classes;
     while (curr) {
@@ -1894,6 +2903,22 @@ void *dragonstone_runtime_define_module(void *name_ptr) {
     return box;
 }
 
+/* Class records and their boxes live for the whole program, even when the
+ * definition runs inside a @[Garbage(area)] function. */
+void *dragonstone_runtime_define_class(void *name_ptr) {
+    ds_global_alloc_depth++;
+    void *box = ds_define_class(name_ptr);
+    ds_global_alloc_depth--;
+    return box;
+}
+
+void *dragonstone_runtime_define_module(void *name_ptr) {
+    ds_global_alloc_depth++;
+    void *box = ds_define_module(name_ptr);
+    ds_global_alloc_depth--;
+    return box;
+}
+
 void dragonstone_runtime_set_superclass(void *class_box_ptr, void *superclass_box_ptr) {
     if (!ds_is_boxed(class_box_ptr) || !ds_is_boxed(superclass_box_ptr)) return;
     DSValue *cbox = (DSValue *)class_box_ptr;
@@ -1902,6 +2927,7 @@ void dragonstone_runtime_set_superclass(void *class_box_ptr, void *superclass_bo
     DSClass *cls = (DSClass *)cbox->as.ptr;
     DSClass *sup = (DSClass *)sbox->as.ptr;
     cls->superclass = sup;
+    ds_method_epoch++;
 }
 
 void *dragonstone_runtime_super_invoke(void *receiver, void *owner_class_box_ptr, void *method_name_ptr, int64_t argc, void **argv, void *block_val) {
@@ -1920,25 +2946,7 @@ void *dragonstone_runtime_super_invoke(void *receiver, void *owner_class_box_ptr
         return NULL;
     }
 
-    if (meth->expects_block) {
-        int64_t argc2 = argc + 1;
-        void *stack_args[8];
-        void **argv2 = NULL;
-
-        if (argc2 <= 8) {
-            for (int64_t i = 0; i < argc; i++) stack_args[i] = argv[i];
-            stack_args[argc] = block_val;
-            argv2 = stack_args;
-        } else {
-            argv2 = (void **)ds_alloc(sizeof(void*) * (size_t)argc2);
-            for (int64_t i = 0; i < argc; i++) argv2[i] = argv[i];
-            argv2[argc] = block_val;
-        }
-
-        return ds_call_method(meth->func_ptr, receiver, argc2, argv2);
-    }
-
-    return ds_call_method(meth->func_ptr, receiver, argc, argv);
+    return ds_invoke_method(meth->func_ptr, meth->expects_block, receiver, argc, argv, block_val);
 }
 
 void *dragonstone_runtime_root_self(void) {
@@ -1948,14 +2956,14 @@ void *dragonstone_runtime_root_self(void) {
     if (!ds_is_boxed(cls_box)) return NULL;
     if (cls_box->kind != DS_VALUE_CLASS) return NULL;
 
+    ds_global_alloc_depth++;
     DSClass *cls = (DSClass *)cls_box->as.ptr;
-    DSInstance *inst = (DSInstance *)ds_alloc(sizeof(DSInstance));
-    inst->klass = cls;
-    inst->ivars = NULL;
+    DSInstance *inst = ds_instance_new(cls);
 
     DSValue *inst_box = ds_new_box(DS_VALUE_INSTANCE);
     inst_box->as.ptr = inst;
     root_self_box = inst_box;
+    ds_global_alloc_depth--;
     return root_self_box;
 }
 
@@ -1971,38 +2979,32 @@ void dragonstone_runtime_extend(void *container_ptr, void *target_ptr) {
     while (meth) {
         bool duplicate = false;
 
-        DSSingletonMethod *existing_singleton = singleton_methods;
+        DSSingletonMethod *existing_singleton = ds_selector_singletons[meth->selector];
         while (existing_singleton) {
-            if (existing_singleton->receiver == container_ptr && strcmp(existing_singleton->name, meth->name) == 0) {
+            if (existing_singleton->receiver == container_ptr) {
                 duplicate = true;
                 break;
             }
-            existing_singleton = existing_singleton->next;
+            existing_singleton = existing_singleton->next_same;
         }
         if (!duplicate) {
-            DSSingletonMethod *node = (DSSingletonMethod *)ds_alloc(sizeof(DSSingletonMethod));
-            node->receiver = container_ptr;
-            node->name = ds_strdup(meth->name);
-            node->func_ptr = meth->func_ptr;
-            node->next = singleton_methods;
-            singleton_methods = node;
+            ds_add_singleton_method(container_ptr, meth->name, meth->func_ptr);
         }
 
         DSMethod *cmeth = container->methods;
         duplicate = false;
         while (cmeth) {
-            if (strcmp(cmeth->name, meth->name) == 0) {
+            if (cmeth->selector == meth->selector) {
                 duplicate = true;
                 break;
             }
             cmeth = cmeth->next;
         }
         if (!duplicate) {
-            DSMethod *copy = (DSMethod *)ds_alloc(sizeof(DSMethod));
-            copy->name = ds_strdup(meth->name);
-            copy->func_ptr = meth->func_ptr;
+            DSMethod *copy = ds_new_method(meth->name, meth->func_ptr, false);
             copy->next = container->methods;
             container->methods = copy;
+            ds_method_epoch++;
         }
         meth = meth->next;
     }
@@ -2013,36 +3015,29 @@ void dragonstone_runtime_extend(void *container_ptr, void *target_ptr) {
     while (sm) {
         if (sm->receiver == target_ptr) {
             bool dup_singleton = false;
-            DSSingletonMethod *existing = singleton_methods;
+            DSSingletonMethod *existing = ds_selector_singletons[sm->selector];
             while (existing) {
-                if (existing->receiver == container_ptr && strcmp(existing->name, sm->name) == 0) {
+                if (existing->receiver == container_ptr) {
                     dup_singleton = true;
                     break;
                 }
-                existing = existing->next;
+                existing = existing->next_same;
             }
             if (!dup_singleton) {
-                DSSingletonMethod *node = (DSSingletonMethod *)ds_alloc(sizeof(DSSingletonMethod));
-                node->receiver = container_ptr;
-                node->name = ds_strdup(sm->name);
-                node->func_ptr = sm->func_ptr;
-                node->next = singleton_methods;
-                singleton_methods = node;
+                ds_add_singleton_method(container_ptr, sm->name, sm->func_ptr);
             }
 
             bool dup_method = false;
             DSMethod *cm = container->methods;
             while (cm) {
-                if (strcmp(cm->name, sm->name) == 0) { dup_method = true; break; }
+                if (cm->selector == sm->selector) { dup_method = true; break; }
                 cm = cm->next;
             }
             if (!dup_method) {
-                DSMethod *copy = (DSMethod *)ds_alloc(sizeof(DSMethod));
-                copy->name = ds_strdup(sm->name);
-                copy->func_ptr = sm->func_ptr;
-                copy->expects_block = false;
+                DSMethod *copy = ds_new_method(sm->name, sm->func_ptr, false);
                 copy->next = container->methods;
                 container->methods = copy;
+                ds_method_epoch++;
             }
         }
         sm = sm->next;
@@ -2055,22 +3050,14 @@ void dragonstone_runtime_define_method(void *class_box_ptr, void *name_ptr, void
     if (box->kind != DS_VALUE_CLASS) return;
     DSClass *cls = (DSClass *)box->as.ptr;
     const char *method_name = (const char *)name_ptr;
-    DSMethod *m = (DSMethod *)ds_alloc(sizeof(DSMethod));
-    m->name = ds_strdup(method_name);
-    m->func_ptr = func_ptr;
-    m->expects_block = expects_block != 0;
+    DSMethod *m = ds_new_method(method_name, func_ptr, expects_block != 0);
     m->next = cls->methods;
     cls->methods = m;
 
-    DSSingletonMethod *snode = (DSSingletonMethod *)ds_alloc(sizeof(DSSingletonMethod));
-    snode->receiver = class_box_ptr;
-    snode->name = ds_strdup(method_name);
-    snode->func_ptr = func_ptr;
-    snode->next = singleton_methods;
-    singleton_methods = snode;
+    ds_add_singleton_method(class_box_ptr, method_name, func_ptr);
 }
 
-void dragonstone_runtime_define_enum_member(void *class_box_ptr, void *name_ptr, int64_t value) {
+static void ds_define_enum_member(void *class_box_ptr, void *name_ptr, int64_t value) {
     if (!ds_is_boxed(class_box_ptr)) return;
     DSValue *box = (DSValue *)class_box_ptr;
     if (box->kind != DS_VALUE_CLASS) return;
@@ -2097,22 +3084,39 @@ void dragonstone_runtime_define_enum_member(void *class_box_ptr, void *name_ptr,
         tail->next = c;
     }
 
-    char *path = ds_join_path(cls->name, name);
+    char *path = ds_join_path(cls->name, c->name);
     ds_constant_set(&global_constants, path, val_box);
 }
 
+void dragonstone_runtime_define_enum_member(void *class_box_ptr, void *name_ptr, int64_t value) {
+    ds_global_alloc_depth++;
+    ds_define_enum_member(class_box_ptr, name_ptr, value);
+    ds_global_alloc_depth--;
+}
+
+static void *ds_class_box(DSClass *cls) {
+    if (!cls->cached_box) {
+        ds_global_alloc_depth++;
+        DSValue *box = ds_new_box(DS_VALUE_CLASS);
+        ds_global_alloc_depth--;
+        box->as.ptr = cls;
+        cls->cached_box = box;
+    }
+    return cls->cached_box;
+}
+
 void *dragonstone_runtime_constant_lookup(int64_t length, void **segments) {
     if (length <= 0) return NULL;
     size_t total_len = 0;
     for (int64_t i = 0; i < length; i++) {
-        total_len += strlen((char *)segments[i]);
+        total_len += ds_string_length((char *)segments[i]);
         if (i < length - 1) total_len += 2;
     }
-    char *path = (char *)ds_alloc(total_len + 1);
+    char *path = ds_string_new(total_len);
     size_t offset = 0;
     for (int64_t i = 0; i < length; i++) {
         const char *seg = (const char *)segments[i];
-        size_t seg_len = strlen(seg);
+        size_t seg_len = ds_string_length(seg);
         memcpy(path + offset, seg, seg_len);
         offset += seg_len;
         if (i < length - 1) {
@@ -2129,11 +3133,7 @@ void *dragonstone_runtime_constant_lookup(int64_t length, void **segments) {
     DSClass *curr = global_classes;
     while (curr) {
         if (strcmp(curr->name, path) == 0 || strcmp(curr->name, last_seg) == 0) {
-            if (curr->cached_box) return curr->cached_box;
-            DSValue *box = ds_new_box(DS_VALUE_CLASS);
-            box->as.ptr = curr;
-            curr->cached_box = box;
-            return box;
+            return ds_class_box(curr);
         }
         curr = curr->next;
     }
@@ -2159,11 +3159,7 @@ void *dragonstone_runtime_constant_lookup(int64_t length, void **segments) {
             DSClass *c = global_classes;
             while (c) {
                 if (strcmp(c->name, tail) == 0) {
-                    if (c->cached_box) return c->cached_box;
-                    DSValue *box = ds_new_box(DS_VALUE_CLASS);
-                    box->as.ptr = c;
-                    c->cached_box = box;
-                    return box;
+                    return ds_class_box(c);
                 }
                 c = c->next;
             }
@@ -2190,12 +3186,10 @@ static void ds_debug_append(char **buffer, const char *part) {
 
     size_t lhs_len = strlen(*buffer);
     size_t rhs_len = strlen(part);
-    size_t new_len = lhs_len + 3 + rhs_len + 1; /* " + " */
-    char *next = (char *)ds_alloc(new_len);
+    char *next = ds_string_new(lhs_len + 3 + rhs_len); /* " + " */
     memcpy(next, *buffer, lhs_len);
     memcpy(next + lhs_len, " + ", 3);
     memcpy(next + lhs_len + 3, part, rhs_len);
-    next[new_len - 1] = '\0';
     *buffer = next;
 }
 
@@ -2259,22 +3253,34 @@ void *dragonstone_runtime_typeof(void *value) {
     }
 }
 
+static int64_t ds_instance_slot_index(DSInstance *inst, const char *name) {
+    DSClass *cls = inst->klass;
+    if (!cls || !cls->ivar_names) return -1;
+    int64_t limit = inst->slot_count < cls->ivar_count ? inst->slot_count : cls->ivar_count;
+    for (int64_t i = 0; i < limit; ++i) {
+        if (cls->ivar_names[i] == name) return i;
+    }
+    for (int64_t i = 0; i < limit; ++i) {
+        if (strcmp(cls->ivar_names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
 void *dragonstone_runtime_ivar_get(void *obj, void *name) {
     if (!ds_is_boxed(obj)) return NULL;
     DSValue *box = (DSValue *)obj;
     if (box->kind != DS_VALUE_INSTANCE) return NULL;
     DSInstance *inst = (DSInstance *)box->as.ptr;
-    if (!inst->ivars) return NULL;
 
     const char *name_str = ds_arg_string(name);
     if (!name_str) return NULL;
 
-    DSMapEntry *curr = inst->ivars->head;
-    while (curr) {
-        if (strcmp((char *)curr->key, name_str) == 0) return curr->value;
-        curr = curr->next;
-    }
-    return NULL;
+    int64_t slot = ds_instance_slot_index(inst, name_str);
+    if (slot >= 0) return inst->slots[slot];
+    if (!inst->ivars) return NULL;
+
+    DSMapEntry *entry = ds_map_find(inst->ivars, (void *)name_str);
+    return entry ? entry->value : NULL;
 }
 
 void *dragonstone_runtime_ivar_set(void *obj, void *name, void *val) {
@@ -2286,41 +3292,76 @@ void *dragonstone_runtime_ivar_set(void *obj, void *name, void *val) {
     const char *name_str = ds_arg_string(name);
     if (!name_str) return val;
 
-    if (!inst->ivars) {
-        inst->ivars = (DSMap *)ds_alloc(sizeof(DSMap));
-        inst->ivars->head = NULL;
-        inst->ivars->count = 0;
+    int64_t slot = ds_instance_slot_index(inst, name_str);
+    if (slot >= 0) {
+        inst->slots[slot] = val;
+        return val;
     }
 
-    DSMapEntry *curr = inst->ivars->head;
-    while (curr) {
-        if (strcmp((char *)curr->key, name_str) == 0) {
-            curr->value = val;
-            return val;
-        }
-        curr = curr->next;
+    if (!inst->ivars) inst->ivars = ds_map_new(0);
+
+    DSMapEntry *entry = ds_map_find(inst->ivars, (void *)name_str);
+    if (entry) {
+        entry->value = val;
+        return val;
     }
 
     ds_map_append_entry(inst->ivars, ds_strdup(name_str), val);
     return val;
 }
 
+/* Registers the compile-time instance-variable layout of a class. `names` is
+ * a constant array in the generated module, so it is kept by reference. The
+ * first layout wins: instances already allocated against it must stay valid
+ * if the class body is reopened. */
+void dragonstone_runtime_define_ivars(void *class_box_ptr, void **names, int64_t count) {
+    if (!ds_is_boxed(class_box_ptr) || !names || count <= 0) return;
+    DSValue *cbox = (DSValue *)class_box_ptr;
+    if (cbox->kind != DS_VALUE_CLASS) return;
+    DSClass *cls = (DSClass *)cbox->as.ptr;
+    if (cls->ivar_names) return;
+    cls->ivar_names = (char **)names;
+    cls->ivar_count = count;
+}
+
+/* Slot array for the direct loads and stores of a compiled method whose class
+ * layout is `layout`, or NULL when `obj` is not an instance laid out with
+ * `layout` as a prefix (class-level calls, instances allocated before the
+ * layout was registered, subclasses compiled against another layout). The
+ * caller then falls back to the by-name accessors. */
+void **dragonstone_runtime_ivar_slots(void *obj, void **layout, int64_t count) {
+    if (!ds_is_boxed(obj)) return NULL;
+    DSValue *box = (DSValue *)obj;
+    if (box->kind != DS_VALUE_INSTANCE) return NULL;
+    DSInstance *inst = (DSInstance *)box->as.ptr;
+    DSClass *cls = inst->klass;
+    if (!cls || inst->slot_count < count) return NULL;
+
+    char **names = (char **)layout;
+    if (cls->ivar_names == names || cls->ivar_verified == names) return inst->slots;
+    if (!cls->ivar_names || cls->ivar_count < count) return NULL;
+    for (int64_t i = 0; i < count; ++i) {
+        if (cls->ivar_names[i] != names[i] && strcmp(cls->ivar_names[i], names[i]) != 0) return NULL;
+    }
+    cls->ivar_verified = names;
+    return inst->slots;
+}
+
 void *dragonstone_runtime_interpolated_string(int64_t length, void **segments) {
     if (length <= 0) return ds_strdup("");
     size_t total_len = 0;
     for (int64_t i = 0; i < length; ++i) {
-        if (segments[i]) total_len += strlen((const char*)segments[i]);
+        if (segments[i]) total_len += ds_string_length((const char*)segments[i]);
     }
-    char *result = (char *)ds_alloc(total_len + 1);
+    char *result = ds_string_new(total_len);
     char *cursor = result;
     for (int64_t i = 0; i < length; ++i) {
         if (segments[i]) {
-            size_t len = strlen((const char*)segments[i]);
+            size_t len = ds_string_length((const char*)segments[i]);
             memcpy(cursor, segments[i], len);
             cursor += len;
         }
     }
-    *cursor = '\0';
     return result;
 }
 
@@ -2349,7 +3390,7 @@ _Bool dragonstone_runtime_case_compare(void *lhs, void *rhs) {
     }
     if (!ds_is_boxed(lhs) && !ds_is_boxed(rhs)) {
         if (!lhs || !rhs) return false;
-        return strcmp((const char*)lhs, (const char*)rhs) == 0;
+        return ds_string_equal((const char*)lhs, (const char*)rhs);
     }
     if (ds_is_boxed(lhs) && !ds_is_boxed(rhs)) {
         return false; 
@@ -2369,6 +3410,7 @@ void *dragonstone_runtime_argv(void) {
     int64_t count = dragonstone_io_argc();
     const char **argv = dragonstone_io_argv();
 
+    ds_global_alloc_depth++;
     DSArray *array = (DSArray *)ds_alloc(sizeof(DSArray));
     array->length = count;
     array->items = count > 0 ? (void **)ds_alloc(sizeof(void *) * (size_t)count) : NULL;
@@ -2381,6 +3423,7 @@ void *dragonstone_runtime_argv(void) {
     box->as.ptr = array;
 
     ds_program_argv_box = box;
+    ds_global_alloc_depth--;
     return box;
 }
 
@@ -2393,9 +3436,7 @@ static void *ds_make_instance(void *class_box_ptr) {
     DSValue *cbox = (DSValue *)class_box_ptr;
     if (cbox->kind != DS_VALUE_CLASS) return NULL;
     DSClass *cls = (DSClass *)cbox->as.ptr;
-    DSInstance *inst = (DSInstance *)ds_alloc(sizeof(DSInstance));
-    inst->klass = cls;
-    inst->ivars = NULL;
+    DSInstance *inst = ds_instance_new(cls);
     DSValue *inst_box = ds_new_box(DS_VALUE_INSTANCE);
     inst_box->as.ptr = inst;
     return inst_box;
@@ -2447,19 +3488,28 @@ static void *ds_iostream_flush(void *receiver) {
     return NULL;
 }
 
+/* The io layer returns malloc'd C strings; copy them into string values. */
+static void *ds_adopt_io_string(char *text) {
+    if (!text) return NULL;
+    char *copy = ds_strdup(text);
+    free(text);
+    return copy;
+}
+
 static void *ds_stdin_read(void *receiver) {
     (void)receiver;
-    return dragonstone_io_read_stdin_line();
+    return ds_adopt_io_string(dragonstone_io_read_stdin_line());
 }
 
 static void *ds_argf_read(void *receiver) {
     (void)receiver;
-    return dragonstone_io_read_argf();
+    return ds_adopt_io_string(dragonstone_io_read_argf());
 }
 
 static void ds_init_io_builtins(void) {
     if (ds_io_builtins_initialized) return;
 
+    ds_global_alloc_depth++;
     ds_builtin_io_stream_class = dragonstone_runtime_define_class((void *)"IOStream");
     dragonstone_runtime_define_method(ds_builtin_io_stream_class, (void *)"eecholn", (void *)&ds_iostream_eecholn, 0);
     dragonstone_runtime_define_method(ds_builtin_io_stream_class, (void *)"echoln", (void *)&ds_iostream_echoln, 0);
@@ -2477,6 +3527,7 @@ static void ds_init_io_builtins(void) {
     ds_builtin_argf_class = dragonstone_runtime_define_class((void *)"ARGF");
     dragonstone_runtime_define_method(ds_builtin_argf_class, (void *)"read", (void *)&ds_argf_read, 0);
     ds_builtin_argf = ds_make_instance(ds_builtin_argf_class);
+    ds_global_alloc_depth--;
 
     ds_io_builtins_initialized = true;
 }
@@ -2505,7 +3556,7 @@ void *dragonstone_runtime_array_literal(int64_t length, void **elements) { retur
 void *dragonstone_runtime_map_literal(int64_t length, void **keys, void **values) { return ds_create_map_box(length, keys, values); }
 
 void *dragonstone_runtime_range_literal(void *from_ptr, void *to_ptr, bool exclusive) {
-    DSRange *rng = (DSRange *)ds_alloc(sizeof(DSRange));
+    DSRange *rng = (DSRange *)ds_alloc_atomic(sizeof(DSRange));
     
     bool from_char = false;
     bool to_char = false;
@@ -2561,14 +3612,8 @@ void *dragonstone_runtime_index_get(void *object, void *index_value) {
 
     if (obj_box->kind == DS_VALUE_MAP) {
         DSMap *map = (DSMap *)obj_box->as.ptr;
-        DSMapEntry *curr = map->head;
-        while (curr) {
-            if (dragonstone_runtime_case_compare(curr->key, index_value)) {
-                return curr->value;
-            }
-            curr = curr->next;
-        }
-        return NULL;
+        DSMapEntry *entry = ds_map_find(map, index_value);
+        return entry ? entry->value : NULL;
     }
 
     return NULL;
@@ -2591,10 +3636,8 @@ void *dragonstone_runtime_index_set(void *object, void *index_value, void *value
         if (idx < 0) idx = array->length + idx;
         if (idx >= array->length) {
             int64_t new_len = idx + 1;
-            void **new_items = (void **)realloc(array->items, sizeof(void*) * new_len);
-            if (!new_items) abort();
-            for (int64_t i = array->length; i < new_len; i++) new_items[i] = NULL;
-            array->items = new_items;
+            ds_array_reserve(array, new_len);
+            for (int64_t i = array->length; i < new_len; i++) array->items[i] = NULL;
             array->length = new_len;
         }
         if (idx >= 0) array->items[idx] = value;
@@ -2603,15 +3646,7 @@ void *dragonstone_runtime_index_set(void *object, void *index_value, void *value
 
     if (obj_box->kind == DS_VALUE_MAP) {
         DSMap *map = (DSMap *)obj_box->as.ptr;
-        DSMapEntry *curr = map->head;
-        while (curr) {
-            if (dragonstone_runtime_case_compare(curr->key, index_value)) {
-                curr->value = value;
-                return value;
-            }
-            curr = curr->next;
-        }
-        ds_map_append_entry(map, index_value, value);
+        ds_map_set(map, index_value, value);
         return value;
     }
 
@@ -2654,9 +3689,9 @@ void *dragonstone_runtime_add(void *lhs, void *rhs) {
 
         if (l->kind == DS_VALUE_INSTANCE) {
             DSInstance *inst = (DSInstance *)l->as.ptr;
-            DSMethod *meth = inst && inst->klass ? ds_lookup_method_from(inst->klass, "+") : NULL;
+            DSMethod *meth = inst && inst->klass ? ds_lookup_selector(inst->klass, DS_SEL_PLUS) : NULL;
             if (!meth) {
-                dragonstone_runtime_raise("Unsupported operands for +");
+                dragonstone_runtime_raise(ds_strdup("Unsupported operands for +"));
                 return NULL;
             }
             void *args[1];
@@ -2672,9 +3707,9 @@ void *dragonstone_runtime_add(void *lhs, void *rhs) {
 
         if (l->kind == DS_VALUE_CLASS) {
             DSClass *cls = (DSClass *)l->as.ptr;
-            DSMethod *meth = cls ? ds_lookup_method_from(cls, "+") : NULL;
+            DSMethod *meth = cls ? ds_lookup_selector(cls, DS_SEL_PLUS) : NULL;
             if (!meth) {
-                dragonstone_runtime_raise("Unsupported operands for +");
+                dragonstone_runtime_raise(ds_strdup("Unsupported operands for +"));
                 return NULL;
             }
             void *args[1];
@@ -2704,7 +3739,7 @@ void *dragonstone_runtime_add(void *lhs, void *rhs) {
             }
         }
 
-        dragonstone_runtime_raise("Unsupported operands for +");
+        dragonstone_runtime_raise(ds_strdup("Unsupported operands for +"));
         return NULL;
     }
 
@@ -2712,12 +3747,11 @@ void *dragonstone_runtime_add(void *lhs, void *rhs) {
     char *lhs_str = (char *)dragonstone_runtime_to_string(lhs);
     char *rhs_str = (char *)dragonstone_runtime_to_string(rhs);
 
-    size_t lhs_len = lhs_str ? strlen(lhs_str) : 0;
-    size_t rhs_len = rhs_str ? strlen(rhs_str) : 0;
-    char *result = (char *)ds_alloc(lhs_len + rhs_len + 1);
+    size_t lhs_len = lhs_str ? ds_string_length(lhs_str) : 0;
+    size_t rhs_len = rhs_str ? ds_string_length(rhs_str) : 0;
+    char *result = ds_string_new(lhs_len + rhs_len);
     if (lhs_len > 0) memcpy(result, lhs_str, lhs_len);
     if (rhs_len > 0) memcpy(result + lhs_len, rhs_str, rhs_len);
-    result[lhs_len + rhs_len] = '\0';
     return result;
 }
 
@@ -2735,11 +3769,13 @@ void *dragonstone_runtime_negate(void *value) {
         }
     }
 
-    dragonstone_runtime_raise("Cannot apply unary minus");
+    dragonstone_runtime_raise(ds_strdup("Cannot apply unary minus"));
     return NULL;
 }
 
-void **dragonstone_runtime_block_env_allocate(int64_t l) { return calloc(l, sizeof(void*)); }
+void **dragonstone_runtime_block_env_allocate(int64_t l) { return (void **)ds_alloc(sizeof(void *) * (size_t)l); }
+/* Heap cells for captured locals; they hold runtime values, so the collector scans them. */
+void *dragonstone_runtime_gc_alloc(int64_t size) { return ds_alloc((size_t)size); }
 void dragonstone_runtime_rescue_placeholder(void) { abort(); }
 void *dragonstone_runtime_define_constant(void *n, void *v) {
     const char *name = (const char *)n;
@@ -2806,7 +3842,7 @@ void *dragonstone_runtime_sub(void *lhs, void *rhs) {
         }
     }
 
-    dragonstone_runtime_raise("Unsupported operands for -");
+    dragonstone_runtime_raise(ds_strdup("Unsupported operands for -"));
     return NULL;
 }
 
@@ -2832,7 +3868,7 @@ void *dragonstone_runtime_mul(void *lhs, void *rhs) {
         }
     }
 
-    dragonstone_runtime_raise("Unsupported operands for *");
+    dragonstone_runtime_raise(ds_strdup("Unsupported operands for *"));
     return NULL;
 }
 
@@ -2843,7 +3879,7 @@ void *dragonstone_runtime_div(void *lhs, void *rhs) {
     if (ds_is_boxed(rhs)) {
         DSValue *r = (DSValue *)rhs;
         if ((r->kind == DS_VALUE_INT32 && r->as.i32 == 0) || (r->kind == DS_VALUE_INT64 && r->as.i64 == 0) || (r->kind == DS_VALUE_FLOAT && r->as.f64 == 0.0)) {
-            dragonstone_runtime_raise("Cannot divide by zero");
+            dragonstone_runtime_raise(ds_strdup("Cannot divide by zero"));
             return NULL;
         }
     }
@@ -2866,7 +3902,7 @@ void *dragonstone_runtime_div(void *lhs, void *rhs) {
         }
     }
 
-    dragonstone_runtime_raise("Unsupported operands for /");
+    dragonstone_runtime_raise(ds_strdup("Unsupported operands for /"));
     return NULL;
 }
 
@@ -2877,7 +3913,7 @@ void *dragonstone_runtime_mod(void *lhs, void *rhs) {
     if (ds_is_boxed(rhs)) {
         DSValue *r = (DSValue *)rhs;
         if ((r->kind == DS_VALUE_INT32 && r->as.i32 == 0) || (r->kind == DS_VALUE_INT64 && r->as.i64 == 0) || (r->kind == DS_VALUE_FLOAT && r->as.f64 == 0.0)) {
-            dragonstone_runtime_raise("Cannot divide by zero");
+            dragonstone_runtime_raise(ds_strdup("Cannot divide by zero"));
             return NULL;
         }
     }
@@ -2900,7 +3936,7 @@ void *dragonstone_runtime_mod(void *lhs, void *rhs) {
         }
     }
 
-    dragonstone_runtime_raise("Unsupported operands for %");
+    dragonstone_runtime_raise(ds_strdup("Unsupported operands for %"));
     return NULL;
 }
 
@@ -2959,7 +3995,7 @@ void *dragonstone_runtime_floor_div(void *lhs, void *rhs) {
     if (ds_is_boxed(rhs)) {
         DSValue *r = (DSValue *)rhs;
         if ((r->kind == DS_VALUE_INT32 && r->as.i32 == 0) || (r->kind == DS_VALUE_INT64 && r->as.i64 == 0) || (r->kind == DS_VALUE_FLOAT && r->as.f64 == 0.0)) {
-            dragonstone_runtime_raise("Cannot divide by zero");
+            dragonstone_runtime_raise(ds_strdup("Cannot divide by zero"));
             return NULL;
         }
     }
@@ -2982,7 +4018,7 @@ void *dragonstone_runtime_floor_div(void *lhs, void *rhs) {
         }
     }
 
-    dragonstone_runtime_raise("Unsupported operands for //");
+    dragonstone_runtime_raise(ds_strdup("Unsupported operands for //"));
     return NULL;
 }
 
@@ -3011,7 +4047,7 @@ void *dragonstone_runtime_pow(void *lhs, void *rhs) {
         }
     }
 
-    dragonstone_runtime_raise("Unsupported operands for **");
+    dragonstone_runtime_raise(ds_strdup("Unsupported operands for **"));
     return NULL;
 }
 
@@ -3193,7 +4229,7 @@ void *dragonstone_runtime_eq(void *lhs, void *rhs) {
     }
 
     if (!ds_is_boxed(lhs) && !ds_is_boxed(rhs)) {
-        return dragonstone_runtime_box_bool(strcmp((const char *)lhs, (const char *)rhs) == 0);
+        return dragonstone_runtime_box_bool(ds_string_equal((const char *)lhs, (const char *)rhs));
     }
 
     return dragonstone_runtime_box_bool(false);
@@ -3214,6 +4250,96 @@ void *dragonstone_runtime_ne(void *lhs, void *rhs) {
     return dragonstone_runtime_box_bool(!v);
 }
 
+/* Mixed operations for compiled code that already holds one operand as a
+ * native integer: that side is never boxed, and int/int results come from
+ * the small-int table when they fit. `int_on_left` gives the operand order;
+ * anything that is not int/int falls back to the generic operator. */
+enum {
+    DS_OP_ADD,
+    DS_OP_SUB,
+    DS_OP_MUL,
+    DS_OP_DIV,
+    DS_OP_MOD,
+    DS_OP_LT,
+    DS_OP_LTE,
+    DS_OP_GT,
+    DS_OP_GTE,
+    DS_OP_EQ,
+    DS_OP_NE
+};
+
+static bool ds_int_operand(void *value, int64_t *out) {
+    if (!ds_is_boxed(value)) return false;
+    DSValue *box = (DSValue *)value;
+    if (box->kind == DS_VALUE_INT64) { *out = box->as.i64; return true; }
+    if (box->kind == DS_VALUE_INT32) { *out = box->as.i32; return true; }
+    return false;
+}
+
+void *dragonstone_runtime_int_arith(int32_t op, void *dynamic, int64_t value, int32_t int_on_left) {
+    int64_t other;
+    if (ds_int_operand(dynamic, &other)) {
+        int64_t l = int_on_left ? value : other;
+        int64_t r = int_on_left ? other : value;
+        switch (op) {
+            case DS_OP_ADD: return dragonstone_runtime_box_i64(l + r);
+            case DS_OP_SUB: return dragonstone_runtime_box_i64(l - r);
+            case DS_OP_MUL: return dragonstone_runtime_box_i64(l * r);
+            case DS_OP_MOD:
+                if (r != 0) return dragonstone_runtime_box_i64(l % r);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void *boxed = dragonstone_runtime_box_i64(value);
+    void *lhs = int_on_left ? boxed : dynamic;
+    void *rhs = int_on_left ? dynamic : boxed;
+    switch (op) {
+        case DS_OP_ADD: return dragonstone_runtime_add(lhs, rhs);
+        case DS_OP_SUB: return dragonstone_runtime_sub(lhs, rhs);
+        case DS_OP_MUL: return dragonstone_runtime_mul(lhs, rhs);
+        case DS_OP_DIV: return dragonstone_runtime_div(lhs, rhs);
+        case DS_OP_MOD: return dragonstone_runtime_mod(lhs, rhs);
+        default:
+            dragonstone_runtime_raise(ds_strdup("Unsupported integer operator"));
+            return NULL;
+    }
+}
+
+int32_t dragonstone_runtime_int_compare(int32_t op, void *dynamic, int64_t value, int32_t int_on_left) {
+    int64_t other;
+    if (ds_int_operand(dynamic, &other)) {
+        int64_t l = int_on_left ? value : other;
+        int64_t r = int_on_left ? other : value;
+        switch (op) {
+            case DS_OP_LT: return l < r;
+            case DS_OP_LTE: return l <= r;
+            case DS_OP_GT: return l > r;
+            case DS_OP_GTE: return l >= r;
+            case DS_OP_EQ: return l == r;
+            case DS_OP_NE: return l != r;
+            default: return 0;
+        }
+    }
+
+    void *boxed = dragonstone_runtime_box_i64(value);
+    void *lhs = int_on_left ? boxed : dynamic;
+    void *rhs = int_on_left ? dynamic : boxed;
+    void *result = NULL;
+    switch (op) {
+        case DS_OP_LT: result = dragonstone_runtime_lt(lhs, rhs); break;
+        case DS_OP_LTE: result = dragonstone_runtime_lte(lhs, rhs); break;
+        case DS_OP_GT: result = dragonstone_runtime_gt(lhs, rhs); break;
+        case DS_OP_GTE: result = dragonstone_runtime_gte(lhs, rhs); break;
+        case DS_OP_EQ: result = dragonstone_runtime_eq(lhs, rhs); break;
+        case DS_OP_NE: result = dragonstone_runtime_ne(lhs, rhs); break;
+        default: return 0;
+    }
+    return dragonstone_runtime_unbox_bool(result);
+}
+
 _Bool dragonstone_runtime_is_truthy(void *value) {
     if (!value) return false;
     if (ds_is_boxed(value)) {
@@ -93,13 +93,14 @@ static void dragonstone_gc_warn(const char* fmt, ...)
     va_end(args);
 }
 
+// strdup is POSIX, not C11; the runtime is built with -std=c11.
 static char* ds_gc_strdup(const char* value)
 {
-#if defined(_WIN32)
-    return value ? _strdup(value) : NULL;
-#else
-    return value ? strdup(value) : NULL;
-#endif
+    if (!value) return NULL;
+    size_t len = strlen(value) + 1;
+    char* copy = malloc(len);
+    if (copy) memcpy(copy, value, len);
+    return copy;
 }
 
 static void dragonstone_gc_area_grow(DragonstoneGcArea* area) 
@@ -324,6 +325,30 @@ void* dragonstone_gc_alloc_atomic(size_t size)
     return ptr;
 }
 
+void* dragonstone_gc_alloc_global(size_t size)
+{
+    if (!dragonstone_gc_global.initialized)
+    {
+        dragonstone_gc_init();
+    }
+
+    // Skip the current area; the caller needs this to outlive it.
+    void* ptr = GC_MALLOC(size);
+    if (!ptr)
+    {
+        dragonstone_gc_collect();
+        ptr = GC_MALLOC(size);
+    }
+
+    if (ptr)
+    {
+        dragonstone_gc_global.total_allocated += size;
+        dragonstone_gc_log("Global alloc: %zu bytes at %p", size, ptr);
+    }
+
+    return ptr;
+}
+
 void* dragonstone_gc_alloc_with_finalizer(size_t size, DragonstoneGcFinalizer finalizer, void* userdata) 
 {
     if (!dragonstone_gc_global.initialized) 
@@ -105,6 +105,16 @@ void* dragonstone_gc_alloc(size_t size);
 */
 void* dragonstone_gc_alloc_atomic(size_t size);
 
+/*
+    * Allocate managed memory outside any active area.
+    * Always uses Boehm GC, for data that must outlive the current area
+    * (runtime tables, caches, interned names).
+    *
+    * @param size  Number of bytes to allocate
+    * @return      Pointer to zeroed memory, or NULL on failure
+*/
+void* dragonstone_gc_alloc_global(size_t size);
+
 /*
     * Allocate memory with a finalizer callback.
     * Finalizer is called when the memory is about to be freed.